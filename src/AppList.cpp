@@ -8,10 +8,11 @@
 
 #include "AppList.h"
 
-#include "IgnoreListItem.h"
 #include "QLSettings.h"
 #include "QuickLaunch.h"
+#include "Trace.h"
 
+#include <Locale.h>
 #include <LocaleRoster.h>
 #include <NodeMonitor.h>
 #include <Path.h>
@@ -20,11 +21,39 @@
 #include <VolumeRoster.h>
 
 
+AppListEntries::AppListEntries(const AppListItems* items,
+	const std::vector<entry_ref>* favorites)
+	:
+	fItems(items),
+	fFavorites(favorites)
+{
+}
+
+
+bool
+AppListEntries::IsFavorite(int32_t index) const
+{
+	if (fFavorites == NULL)
+		return false;
+
+	const entry_ref& ref = *fItems->ItemAt(index)->GetRef();
+	for (size_t i = 0; i < fFavorites->size(); i++) {
+		if ((*fFavorites)[i] == ref)
+			return true;
+	}
+	return false;
+}
+
+
+#pragma mark-- AppList --
+
+
 AppList::AppList()
 	:
 	BLooper("app list builder"),
 	fInit(false),
-	fAppList(20, true)
+	fGeneration(0),
+	fAppList(20, false)
 {
 	Run();
 }
@@ -34,6 +63,8 @@ AppList::~AppList()
 {
 	if (fInit)
 		stop_watching(this);
+
+	_MakeEmpty();
 }
 
 
@@ -43,7 +74,11 @@ AppList::MessageReceived(BMessage* message)
 	switch (message->what) {
 		case BUILDAPPLIST:
 		{
-			_BuildAppList();
+			// Requests that were queued before a newer one are dropped, only
+			// the latest generation gets built
+			int32 generation = message->GetInt32("generation", atomic_get(&fGeneration));
+			if (!_IsSuperseded(generation))
+				_BuildAppList(generation);
 			break;
 		}
 		case B_NODE_MONITOR:
@@ -53,21 +88,46 @@ AppList::MessageReceived(BMessage* message)
 			if (opcode == B_DEVICE_MOUNTED) {
 				int32 device;
 				if (message->FindInt32("new device", 0, &device) != B_OK) {
-					_BuildAppList();
+					Rebuild();
 					break;
 				}
 
+				// Like a build, the new items are only added when complete
 				bool localized = BLocaleRoster::Default()->IsFilesystemTranslationPreferred();
+				int32 generation = atomic_get(&fGeneration);
 				BVolume volume(device);
-				if (_AppendVolumeItems(volume, localized) > 0)
+				AppListItems added(20, false);
+				if (_AppendVolumeItems(added, volume, localized, generation) > 0
+					&& !_IsSuperseded(generation)) {
+					for (int32 i = 0; i < added.CountItems(); i++)
+						fAppList.BinaryInsert(added.ItemAt(i), &AppListItem::Compare);
+					added.MakeEmpty();
+					_ApplyIgnoreList();
 					SendNotices(BUILDAPPLIST);
+				} else
+					_ReleaseItems(added);
 
 			} else if (opcode == B_DEVICE_UNMOUNTED) {
-				_BuildAppList();
+				Rebuild();
 			}
 
 			break;
 		}
+		case B_LOCALE_CHANGED:
+		{
+			if (fInit)
+				_LocaleChanged();
+			break;
+		}
+		case IGNORELIST_CHANGED:
+		{
+			if (!fInit)
+				break;
+
+			_ApplyIgnoreList();
+			SendNotices(BUILDAPPLIST);
+			break;
+		}
 		default:
 		{
 			BLooper::MessageReceived(message);
@@ -84,39 +144,46 @@ AppList::Items()
 		return &fAppList;
 
 	if (!fInit)
-		PostMessage(BUILDAPPLIST);
+		Rebuild();
 
 	return NULL;
 }
 
 
+void
+AppList::Rebuild()
+{
+	// Every request gets a new generation. A build in progress checks it
+	// between query results and gives up as soon as a newer one is pending.
+	BMessage message(BUILDAPPLIST);
+	message.AddInt32("generation", atomic_add(&fGeneration, 1) + 1);
+	PostMessage(&message);
+}
+
+
+void
+AppList::UnloadIcons()
+{
+	// Icons are only loaded and used by the window, call from its thread.
+	// While a build keeps the list locked there's nothing to unload anyway.
+	if (LockWithTimeout(0) != B_OK)
+		return;
+
+	for (int32 i = 0; i < fAppList.CountItems(); i++)
+		fAppList.ItemAt(i)->UnloadIcon();
+
+	Unlock();
+}
+
+
 int
-AppList::_AppendVolumeItems(const BVolume& volume, bool localized)
+AppList::_AppendVolumeItems(AppListItems& list, const BVolume& volume, bool localized,
+	int32 generation)
 {
+	TRACE_SPAN("AppList::_AppendVolumeItems");
 	if (volume.InitCheck() != B_OK || !volume.KnowsQuery())
 		return 0;
 
-	QLSettings& settings = my_app->Settings();
-	int32 ignoreCount;
-	if (settings.GetTempApplyIgnore())
-		ignoreCount = settings.fIgnoreList->CountItems();
-	else
-		ignoreCount = 0;
-
-	// Check if the whole volume is on ignore list
-	if (ignoreCount > 0) {
-		BDirectory root;
-		volume.GetRootDirectory(&root);
-		BPath mountPoint(&root, NULL);
-
-		BString newItem(mountPoint.Path());
-		for (int i = 0; i < ignoreCount; i++) {
-			IgnoreListItem* sItem = dynamic_cast<IgnoreListItem*>(settings.fIgnoreList->ItemAt(i));
-			if (sItem->Ignores(newItem))
-				return 0;
-		}
-	}
-
 	int appended = 0;
 	BQuery query;
 
@@ -146,6 +213,9 @@ AppList::_AppendVolumeItems(const BVolume& volume, bool localized)
 	BEntry entry;
 	BPath path;
 	while (query.GetNextEntry(&entry) == B_OK) {
+		if (_IsSuperseded(generation))
+			break;
+
 		if (!entry.IsFile())
 			continue;
 
@@ -165,21 +235,10 @@ AppList::_AppendVolumeItems(const BVolume& volume, bool localized)
 				continue;
 		}
 
-		bool ignore = false;
-		if (ignoreCount > 0) {
-			BString newItem(path.Path());
-			for (int i = 0; i < ignoreCount; i++) {
-				IgnoreListItem* sItem = dynamic_cast<IgnoreListItem*>(
-					settings.fIgnoreList->ItemAt(i));
-
-				if (sItem->Ignores(newItem)) {
-					ignore = true;
-					break;
-				}
-			}
-		}
-		if (!ignore && entry.InitCheck() == B_OK) {
-			fAppList.AddItem(new AppListItem(entry, localized));
+		// The ignore list is not applied here, but evaluated for the
+		// search engine by _ApplyIgnoreList()
+		if (entry.InitCheck() == B_OK) {
+			list.AddItem(new AppListItem(entry, path, localized, fCollator));
 			appended++;
 		}
 	}
@@ -189,21 +248,97 @@ AppList::_AppendVolumeItems(const BVolume& volume, bool localized)
 
 
 void
-AppList::_BuildAppList()
+AppList::_BuildAppList(int32 generation)
 {
+	TRACE_SPAN("AppList::_BuildAppList");
 	if (!fInit) {
 		fInit = true;
 		watch_node(NULL, B_WATCH_MOUNT, this);
 	}
 
-	fAppList.MakeEmpty();
+	BLocale::Default()->GetCollator(&fCollator);
 
+	// The new list is built aside and only replaces the current one when
+	// it's complete. A superseded build leaves the current list as it is.
+	AppListItems list(20, false);
 	bool localized = BLocaleRoster::Default()->IsFilesystemTranslationPreferred();
 
 	BVolumeRoster volumeRoster;
 	BVolume volume;
-	while (volumeRoster.GetNextVolume(&volume) == B_OK)
-		_AppendVolumeItems(volume, localized);
+	while (volumeRoster.GetNextVolume(&volume) == B_OK && !_IsSuperseded(generation))
+		_AppendVolumeItems(list, volume, localized, generation);
 
+	if (_IsSuperseded(generation)) {
+		_ReleaseItems(list);
+		return;
+	}
+
+	// The list is kept in display order, so filtering it yields sorted results
+	{
+		TRACE_SPAN("AppList sort");
+		list.SortItems(&AppListItem::Compare);
+	}
+
+	_MakeEmpty();
+	fAppList.AddList(&list);
+	_ApplyIgnoreList();
 	SendNotices(BUILDAPPLIST);
 }
+
+
+void
+AppList::_ApplyIgnoreList()
+{
+	TRACE_SPAN("AppList::_ApplyIgnoreList");
+	IgnoreRules& rules = my_app->Settings().GetIgnoreRules();
+	std::lock_guard<std::mutex> lock(rules.Mutex());
+
+	fSearchEngine.ApplyIgnoreRules(AppListEntries(&fAppList), rules);
+}
+
+
+bool
+AppList::_IsSuperseded(int32 generation)
+{
+	return atomic_get(&fGeneration) != generation;
+}
+
+
+void
+AppList::_LocaleChanged()
+{
+	// Localized names and sort keys depend on the locale, the rest of the
+	// list stays as it is
+	BLocale::Default()->GetCollator(&fCollator);
+	bool localized = BLocaleRoster::Default()->IsFilesystemTranslationPreferred();
+
+	// Items may be shown by the window right now, so they are replaced by
+	// relocalized copies instead of being changed
+	for (int32 i = 0; i < fAppList.CountItems(); i++) {
+		AppListItem* item = fAppList.ItemAt(i);
+		fAppList.ReplaceItem(i, new AppListItem(*item, localized, fCollator));
+		item->ReleaseReference();
+	}
+
+	fAppList.SortItems(&AppListItem::Compare);
+	_ApplyIgnoreList();
+	SendNotices(BUILDAPPLIST);
+}
+
+
+void
+AppList::_MakeEmpty()
+{
+	_ReleaseItems(fAppList);
+}
+
+
+/*static*/ void
+AppList::_ReleaseItems(AppListItems& list)
+{
+	// Items that are still shown in a result row live on until it's gone
+	for (int32 i = 0; i < list.CountItems(); i++)
+		list.ItemAt(i)->ReleaseReference();
+
+	list.MakeEmpty();
+}
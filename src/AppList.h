@@ -8,7 +8,9 @@
 
 
 #include "AppListItem.h"
+#include "SearchEngine.h"
 
+#include <Collator.h>
 #include <Looper.h>
 #include <ObjectList.h>
 #include <Volume.h>
@@ -17,6 +19,26 @@
 typedef BObjectList<AppListItem> AppListItems;
 
 
+// The app list as the search engine sees it. Favorites are the entries
+// whose ref is in the given list.
+class AppListEntries : public EntryProvider {
+public:
+							AppListEntries(const AppListItems* items,
+								const std::vector<entry_ref>* favorites = NULL);
+
+	int32_t					CountEntries() const { return fItems->CountItems(); };
+	const char*				NameAt(int32_t index) const
+								{ return fItems->ItemAt(index)->GetName().String(); };
+	const char*				PathAt(int32_t index) const
+								{ return fItems->ItemAt(index)->GetPath().String(); };
+	bool					IsFavorite(int32_t index) const;
+
+private:
+	const AppListItems*		fItems;
+	const std::vector<entry_ref>* fFavorites;
+};
+
+
 class AppList : public BLooper {
 public:
 							AppList();
@@ -25,14 +47,27 @@ public:
 	void					MessageReceived(BMessage* message);
 
 	const AppListItems*		Items();
+	// Only to be used while the list is locked
+	SearchEngine&			Engine() { return fSearchEngine; };
+	void					Rebuild();
+	void					UnloadIcons();
 
 private:
-	int						_AppendVolumeItems(const BVolume& volume, bool localized);
-	void					_BuildAppList();
+	int						_AppendVolumeItems(AppListItems& list, const BVolume& volume,
+								bool localized, int32 generation);
+	void					_ApplyIgnoreList();
+	void					_BuildAppList(int32 generation);
+	bool					_IsSuperseded(int32 generation);
+	void					_LocaleChanged();
+	void					_MakeEmpty();
+	static	void			_ReleaseItems(AppListItems& list);
 
 private:
 	bool					fInit;
-	AppListItems			fAppList;
+	int32					fGeneration;
+	AppListItems			fAppList; // display order, a reference per item
+	SearchEngine			fSearchEngine; // knows the ignored items
+	BCollator				fCollator;
 
 };
 
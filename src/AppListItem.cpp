@@ -7,17 +7,200 @@
  */
 
 #include "AppListItem.h"
+#include "SearchEngine.h"
+#include "Trace.h"
 
+#include <File.h>
 #include <LocaleRoster.h>
+#include <MimeType.h>
+#include <Node.h>
+#include <NodeInfo.h>
 
+#include <string.h>
 
-AppListItem::AppListItem(BEntry entry, bool localized)
+
+static const char* kAppMimeType = "application/x-vnd.Be-elfexecutable";
+
+
+AppListItem::AppListItem(BEntry entry, const BPath& path, bool localized,
+	const BCollator& collator)
+	:
+	fPath(path.Path()),
+	fIsNoApp(false),
+	fIcon(NULL),
+	fIconSize(0),
+	fVersionLoaded(false)
 {
 	entry.GetRef(&fRef);
-	fName = fRef.name;
 
+	fSortPath = fPath;
+	fSortPath.ToLower();
+
+	_Localize(localized, collator);
+}
+
+
+AppListItem::AppListItem(const BEntry& entry, bool localized)
+	:
+	fIsNoApp(false),
+	fIcon(NULL),
+	fIconSize(0),
+	fVersionLoaded(false)
+{
+	entry.GetRef(&fRef);
+
+	BPath path;
+	if (entry.GetPath(&path) == B_OK)
+		fPath = path.Path();
+
+	// Unlike app list entries, which are found by their type, these can be
+	// any file
+	BNode node(&entry);
+	BNodeInfo nodeInfo(&node);
+	char mimeString[B_MIME_TYPE_LENGTH];
+	if (nodeInfo.InitCheck() == B_OK && nodeInfo.GetType(mimeString) == B_OK)
+		fIsNoApp = strcasecmp(mimeString, kAppMimeType) != 0;
+
+	_SetName(localized);
+}
+
+
+AppListItem::AppListItem(const AppListItem& other, bool localized,
+	const BCollator& collator)
+	:
+	BReferenceable(),
+	fRef(other.fRef),
+	fPath(other.fPath),
+	fSortPath(other.fSortPath),
+	fIsNoApp(other.fIsNoApp),
+	fIcon(NULL),
+	fIconSize(0),
+	fVersionLoaded(false)
+{
+	_Localize(localized, collator);
+}
+
+
+AppListItem::~AppListItem()
+{
+	delete fIcon;
+}
+
+
+BBitmap*
+AppListItem::Icon(int32 iconSize)
+{
+	if (fIconSize != iconSize)
+		_LoadIcon(iconSize);
+
+	return fIcon;
+}
+
+
+void
+AppListItem::UnloadIcon()
+{
+	delete fIcon;
+	fIcon = NULL;
+	fIconSize = 0;
+}
+
+
+const version_info&
+AppListItem::Version()
+{
+	if (fVersionLoaded)
+		return fVersionInfo;
+
+	fVersionLoaded = true;
+	memset(&fVersionInfo, 0, sizeof(fVersionInfo));
+
+	BFile file(&fRef, B_READ_ONLY);
+	if (file.InitCheck() != B_OK)
+		return fVersionInfo;
+	BAppFileInfo info(&file);
+	if (info.InitCheck() != B_OK)
+		return fVersionInfo;
+	if (info.GetVersionInfo(&fVersionInfo, B_APP_VERSION_KIND) != B_OK)
+		memset(&fVersionInfo, 0, sizeof(fVersionInfo));
+
+	return fVersionInfo;
+}
+
+
+/*static*/ int
+AppListItem::Compare(const AppListItem* a, const AppListItem* b)
+{
+	return SearchEngine::CompareEntries(a->fSortKey.String(), a->fSortPath.String(),
+		b->fSortKey.String(), b->fSortPath.String());
+}
+
+
+#pragma mark-- Private Methods --
+
+
+void
+AppListItem::_Localize(bool localized, const BCollator& collator)
+{
+	_SetName(localized);
+
+	// The sort key only depends on the name and the locale, so it is only
+	// generated here, when either changes. Comparing items is then a plain
+	// byte comparison.
+	if (collator.GetSortKey(fName.String(), &fSortKey) != B_OK) {
+		fSortKey = fName;
+		fSortKey.ToLower();
+	}
+}
+
+
+void
+AppListItem::_SetName(bool localized)
+{
+	fName = fRef.name;
 	if (localized) {
 		if (BLocaleRoster::Default()->GetLocalizedFileName(fName, fRef) != B_OK)
 			fName = fRef.name;
 	}
 }
+
+
+void
+AppListItem::_LoadIcon(int32 iconSize)
+{
+	TRACE_SPAN("AppListItem::_LoadIcon");
+	delete fIcon;
+	fIcon = NULL;
+	fIconSize = iconSize;
+
+	// In case a non-app favorite is a link, traverse to the source
+	// to get the right icon
+	BEntry entry(&fRef, fIsNoApp);
+	BNode node(&entry);
+	BNodeInfo nodeInfo(&node);
+	if (nodeInfo.InitCheck() != B_OK)
+		return;
+
+	BBitmap* icon = new BBitmap(BRect(0, 0, iconSize, iconSize), 0, B_RGBA32);
+	if (nodeInfo.GetIcon(icon, icon_size(iconSize)) == B_OK) {
+		fIcon = icon;
+		return;
+	}
+
+	char mimeString[B_MIME_TYPE_LENGTH];
+	BMimeType nodeType;
+	if (nodeInfo.GetType(mimeString) != B_OK) {
+		entry_ref ref;
+		entry.GetRef(&ref);
+		if (BMimeType::GuessMimeType(&ref, &nodeType) == B_OK)
+			nodeInfo.SetType(nodeType.Type());
+		else
+			nodeType.SetTo(kAppMimeType);
+	} else
+		nodeType.SetTo(mimeString);
+
+	if (nodeType.GetIcon(icon, icon_size(iconSize)) == B_OK)
+		fIcon = icon;
+	else
+		delete icon;
+}
@@ -9,20 +9,59 @@
 #define APPLISTITEM_H
 
 
+#include <AppFileInfo.h>
+#include <Bitmap.h>
+#include <Collator.h>
 #include <Entry.h>
+#include <Path.h>
+#include <Referenceable.h>
 #include <String.h>
 
 
-class AppListItem {
+// One entry of the app list. Result rows only keep a reference to it, so the
+// name, path, icon and version exist once, however many rows show the entry
+// and even after the app list was rebuilt without it.
+
+class AppListItem : public BReferenceable {
 public:
-	AppListItem(BEntry entry, bool localized);
+	AppListItem(BEntry entry, const BPath& path, bool localized,
+		const BCollator& collator);
+	// For entries that aren't in the app list, i.e. favorites
+	AppListItem(const BEntry& entry, bool localized);
+	// A copy with the name localized anew
+	AppListItem(const AppListItem& other, bool localized,
+		const BCollator& collator);
+	virtual ~AppListItem();
 
-	BString GetName() { return fName; };
+	const BString& GetName() { return fName; };
 	entry_ref* GetRef() { return &fRef; };
-	
+	const BString& GetPath() { return fPath; };
+	bool IsNoApp() { return fIsNoApp; };
+
+	// Loaded on first use, only to be called from the window's thread
+	BBitmap* Icon(int32 iconSize);
+	const version_info& Version();
+	void UnloadIcon();
+
+	// Display order: name by the locale's collation, then path
+	static int Compare(const AppListItem* a, const AppListItem* b);
+
 private:
+	void _Localize(bool localized, const BCollator& collator);
+	void _SetName(bool localized);
+	void _LoadIcon(int32 iconSize);
+
 	entry_ref fRef;
 	BString fName;
+	BString fPath;
+	BString fSortKey;
+	BString fSortPath;
+	bool fIsNoApp;
+
+	BBitmap* fIcon;
+	int32 fIconSize;
+	version_info fVersionInfo;
+	bool fVersionLoaded;
 };
 
 #endif // APPLISTITEM_H
@@ -13,16 +13,18 @@
 #include "IgnoreListItem.h"
 
 
-IgnoreListItem::IgnoreListItem(BString item)
+IgnoreListItem::IgnoreListItem(BString item, bool isPattern)
 	:
 	BListItem(),
-	fItemString(item)
+	fItemString(item),
+	fIsPattern(isPattern),
+	fTruncatedWidth(-1)
 {
 	fPath = new BPath(item.String());
 
 	struct stat s;
-	stat(fPath->Path(), &s);
-	fIsDirectory = S_ISDIR(s.st_mode);
+	fIsDirectory = !fIsPattern && fPath->InitCheck() == B_OK
+		&& stat(fPath->Path(), &s) == 0 && S_ISDIR(s.st_mode);
 }
 
 
@@ -63,7 +65,9 @@ IgnoreListItem::DrawItem(BView* view, BRect rect, bool complete)
 	font_height finfo;
 	font.GetHeight(&finfo);
 
-	if (fIsDirectory)
+	if (fIsPattern)
+		font.SetFace(B_BOLD_FACE);
+	else if (fIsDirectory)
 		font.SetFace(B_ITALIC_FACE);
 	else
 		font.SetFace(B_REGULAR_FACE);
@@ -74,34 +78,17 @@ IgnoreListItem::DrawItem(BView* view, BRect rect, bool complete)
 		rect.top - 2 + ((rect.Height() - (finfo.ascent + finfo.descent + finfo.leading)) / 2)
 			+ (finfo.ascent + finfo.descent));
 
-	float width, height;
-	view->GetPreferredSize(&width, &height);
-	BString string(fItemString);
+	// Only truncate again when the width or the font changed
+	if (fTruncatedWidth != rect.Width() || fTruncatedFont != font) {
+		fTruncatedWidth = rect.Width();
+		fTruncatedFont = font;
 
-	if (fIsDirectory)
-		string << " *";
+		fTruncated = fItemString;
+		if (fIsDirectory)
+			fTruncated << " *";
 
-	view->TruncateString(&string, B_TRUNCATE_MIDDLE, width - spacing);
-	view->DrawString(string.String());
-}
-
-
-#pragma mark-- Public Methods --
-
-
-bool
-IgnoreListItem::Ignores(const BString& path) const
-{
-	BString sPath = path;
-
-	if (fIsDirectory) {
-		BPath container = sPath.String();
-		while (sPath.Length() > GetItem().Length()) {
-			if (container.GetParent(&container) != B_OK)
-				break;
-			sPath = container.Path();
-		}
+		font.TruncateString(&fTruncated, B_TRUNCATE_MIDDLE, fTruncatedWidth - spacing);
 	}
-
-	return sPath.Compare(GetItem()) == 0;
+	view->DrawString(fTruncated.String());
 }
+
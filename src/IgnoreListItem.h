@@ -24,18 +24,24 @@
 
 class IgnoreListItem : public BListItem {
 public:
-					IgnoreListItem(BString item);
+					IgnoreListItem(BString item, bool isPattern = false);
 					~IgnoreListItem();
 
 	virtual void	DrawItem(BView*, BRect, bool);
 
 	const BString&	GetItem() const { return fItemString; };
-	bool			Ignores(const BString& path) const;
+	bool			IsDirectory() const { return fIsDirectory; };
+	bool			IsPattern() const { return fIsPattern; };
 
 private:
 	BPath*			fPath;
 	BString			fItemString;
 	bool			fIsDirectory;
+	bool			fIsPattern;
+
+	BString			fTruncated;
+	float			fTruncatedWidth;
+	BFont			fTruncatedFont;
 };
 
 #endif // IgnoreListItem_H
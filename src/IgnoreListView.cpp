@@ -55,10 +55,7 @@ IgnoreListView::FrameResized(float w, float h)
 {
 	BListView::FrameResized(w, h);
 
-	for (int32 i = 0; i < CountItems(); i++) {
-		BListItem* item = ItemAt(i);
-		item->Update(this, be_plain_font);
-	}
+	// Items truncate their text again when drawn with a new width
 	Invalidate();
 }
 
@@ -0,0 +1,411 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "IgnoreRules.h"
+
+#include <algorithm>
+#include <string.h>
+
+
+static const char* kAnyDepth = "**";
+
+
+static int
+compare_component(const std::string& a, const char* b, size_t length)
+{
+	int cmp = memcmp(a.data(), b, a.size() < length ? a.size() : length);
+	if (cmp != 0)
+		return cmp;
+	if (a.size() == length)
+		return 0;
+
+	return a.size() < length ? -1 : 1;
+}
+
+
+static const char*
+next_component(const char* path, size_t* _length)
+{
+	while (*path == '/')
+		path++;
+
+	const char* end = strchr(path, '/');
+	*_length = end != NULL ? size_t(end - path) : strlen(path);
+	return path;
+}
+
+
+static bool
+has_wildcards(const char* string, size_t length)
+{
+	for (size_t i = 0; i < length; i++) {
+		if (string[i] == '*' || string[i] == '?' || string[i] == '[')
+			return true;
+	}
+	return false;
+}
+
+
+// Returns the end of the wildcard token at "index", or 0 if it's a literal.
+// An unterminated "[" counts as a wildcard, which only makes the index a
+// bit less selective.
+static size_t
+wildcard_end(const char* pattern, size_t length, size_t index)
+{
+	if (pattern[index] == '*' || pattern[index] == '?')
+		return index + 1;
+	if (pattern[index] != '[')
+		return 0;
+
+	size_t i = index + 1;
+	if (i < length && pattern[i] == '!')
+		i++;
+	size_t start = i;
+	while (i < length && (pattern[i] != ']' || i == start))
+		i++;
+
+	return i < length ? i + 1 : index + 1;
+}
+
+
+// Pattern edges are keyed by the first character of the literal prefix,
+// or by the last character of the literal suffix offset by kSuffixKey.
+// Patterns with neither, like "*.*", go last with kAnyKey.
+static const int32_t kSuffixKey = 256;
+static const int32_t kAnyKey = 512;
+
+
+// Matches a single path component against a pattern with "*", "?" and
+// "[...]" (ranges and "!" negation), "*" never crosses a "/".
+static bool
+match_component(const std::string& pattern, const char* name, size_t length)
+{
+	size_t p = 0;
+	size_t n = 0;
+	size_t starPattern = std::string::npos;
+	size_t starName = 0;
+
+	while (n < length) {
+		if (p < pattern.size() && pattern[p] == '*') {
+			starPattern = p++;
+			starName = n;
+			continue;
+		}
+
+		bool matched = false;
+		size_t next = p + 1;
+		if (p < pattern.size()) {
+			if (pattern[p] == '?')
+				matched = true;
+			else if (pattern[p] == '[') {
+				size_t i = p + 1;
+				bool negate = i < pattern.size() && pattern[i] == '!';
+				if (negate)
+					i++;
+				bool inSet = false;
+				size_t start = i;
+				while (i < pattern.size() && (pattern[i] != ']' || i == start)) {
+					if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+						if (name[n] >= pattern[i] && name[n] <= pattern[i + 2])
+							inSet = true;
+						i += 3;
+					} else {
+						if (name[n] == pattern[i])
+							inSet = true;
+						i++;
+					}
+				}
+				if (i < pattern.size()) {
+					matched = inSet != negate;
+					next = i + 1;
+				} else // no closing bracket, take it literally
+					matched = name[n] == '[';
+			} else
+				matched = pattern[p] == name[n];
+		}
+
+		if (matched) {
+			p = next;
+			n++;
+		} else if (starPattern != std::string::npos) {
+			p = starPattern + 1;
+			n = ++starName;
+		} else
+			return false;
+	}
+
+	while (p < pattern.size() && pattern[p] == '*')
+		p++;
+
+	return p == pattern.size();
+}
+
+
+IgnoreRules::IgnoreRules()
+	:
+	fRuleCount(0)
+{
+	MakeEmpty();
+}
+
+
+void
+IgnoreRules::MakeEmpty()
+{
+	fNodes.clear();
+	_AddNode("", 0);
+	fRuleCount = 0;
+}
+
+
+void
+IgnoreRules::AddRule(const char* path, bool isDirectory)
+{
+	int32_t node = 0;
+	size_t length;
+	for (const char* component = next_component(path, &length); length > 0;
+			component = next_component(component + length, &length)) {
+		size_t insertIndex;
+		int32_t child = _FindChild(node, component, length, &insertIndex);
+		if (child < 0) {
+			child = _AddNode(component, length);
+			std::vector<int32_t>& children = fNodes[node].children;
+			children.insert(children.begin() + insertIndex, child);
+		}
+		node = child;
+	}
+
+	if (isDirectory)
+		fNodes[node].ignoresSubtree = true;
+	else
+		fNodes[node].ignoresExact = true;
+
+	fRuleCount++;
+}
+
+
+void
+IgnoreRules::AddPattern(const char* pattern)
+{
+	std::string rule;
+	if (pattern[0] != '/')
+		rule = kAnyDepth;
+	rule.append("/").append(pattern);
+
+	int32_t node = 0;
+	size_t length;
+	for (const char* component = next_component(rule.c_str(), &length); length > 0;
+			component = next_component(component + length, &length)) {
+		int32_t child;
+		if (length == 2 && strncmp(component, kAnyDepth, 2) == 0) {
+			child = fNodes[node].anyDepthChild;
+			if (child < 0) {
+				child = _AddNode(component, length);
+				fNodes[child].isAnyDepth = true;
+				fNodes[node].anyDepthChild = child;
+			}
+		} else if (has_wildcards(component, length))
+			child = _AddPatternChild(node, component, length);
+		else {
+			size_t insertIndex;
+			child = _FindChild(node, component, length, &insertIndex);
+			if (child < 0) {
+				child = _AddNode(component, length);
+				std::vector<int32_t>& children = fNodes[node].children;
+				children.insert(children.begin() + insertIndex, child);
+			}
+		}
+		node = child;
+	}
+
+	fNodes[node].ignoresSubtree = true;
+	fRuleCount++;
+}
+
+
+bool
+IgnoreRules::Ignores(const char* path) const
+{
+	// Walks all matching branches of the trie at once, one component at a time
+	fStates.clear();
+	_AddState(fStates, 0);
+
+	size_t length;
+	for (const char* component = next_component(path, &length); length > 0;
+			component = next_component(component + length, &length)) {
+		for (size_t i = 0; i < fStates.size(); i++) {
+			if (fNodes[fStates[i]].ignoresSubtree)
+				return true;
+		}
+
+		fNextStates.clear();
+		for (size_t i = 0; i < fStates.size(); i++) {
+			const Node& node = fNodes[fStates[i]];
+			if (node.isAnyDepth)
+				_AddState(fNextStates, fStates[i]);
+
+			int32_t child = _FindChild(fStates[i], component, length);
+			if (child >= 0)
+				_AddState(fNextStates, child);
+
+			if (!node.patternChildren.empty()) {
+				_AddPatternStates(fNextStates, node, (uint8_t)component[0],
+					component, length);
+				_AddPatternStates(fNextStates, node,
+					kSuffixKey + (uint8_t)component[length - 1], component, length);
+				_AddPatternStates(fNextStates, node, kAnyKey, component, length);
+			}
+		}
+
+		if (fNextStates.empty())
+			return false;
+		fStates.swap(fNextStates);
+	}
+
+	for (size_t i = 0; i < fStates.size(); i++) {
+		const Node& node = fNodes[fStates[i]];
+		if (node.ignoresSubtree || node.ignoresExact)
+			return true;
+	}
+	return false;
+}
+
+
+#pragma mark-- Private Methods --
+
+
+int32_t
+IgnoreRules::_AddNode(const char* name, size_t length)
+{
+	fNodes.push_back(Node());
+	Node& node = fNodes.back();
+	node.name.assign(name, length);
+	node.anyDepthChild = -1;
+	node.prefixLength = 0;
+	node.suffixLength = 0;
+	node.isAnyDepth = false;
+	node.ignoresSubtree = false;
+	node.ignoresExact = false;
+
+	return fNodes.size() - 1;
+}
+
+
+int32_t
+IgnoreRules::_FindChild(int32_t node, const char* name, size_t length,
+	size_t* _insertIndex) const
+{
+	const std::vector<int32_t>& children = fNodes[node].children;
+
+	size_t low = 0;
+	size_t high = children.size();
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+		int cmp = compare_component(fNodes[children[mid]].name, name, length);
+		if (cmp == 0)
+			return children[mid];
+		if (cmp < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (_insertIndex != NULL)
+		*_insertIndex = low;
+
+	return -1;
+}
+
+
+int32_t
+IgnoreRules::_AddPatternChild(int32_t node, const char* name, size_t length)
+{
+	size_t prefixLength = 0;
+	while (prefixLength < length && wildcard_end(name, length, prefixLength) == 0)
+		prefixLength++;
+
+	size_t suffixStart = prefixLength;
+	for (size_t i = prefixLength; i < length; i++) {
+		size_t end = wildcard_end(name, length, i);
+		if (end > 0) {
+			suffixStart = end;
+			i = end - 1;
+		}
+	}
+	size_t suffixLength = length - suffixStart;
+
+	int32_t key = kAnyKey;
+	if (prefixLength > 0)
+		key = (uint8_t)name[0];
+	else if (suffixLength > 0)
+		key = kSuffixKey + (uint8_t)name[length - 1];
+
+	std::vector<PatternEdge>& edges = fNodes[node].patternChildren;
+	size_t index = 0;
+	while (index < edges.size() && edges[index].key < key)
+		index++;
+	for (; index < edges.size() && edges[index].key == key; index++) {
+		if (compare_component(fNodes[edges[index].node].name, name, length) == 0)
+			return edges[index].node;
+	}
+
+	int32_t child = _AddNode(name, length);
+	fNodes[child].prefixLength = prefixLength;
+	fNodes[child].suffixLength = suffixLength;
+
+	PatternEdge edge = { key, child };
+	std::vector<PatternEdge>& children = fNodes[node].patternChildren;
+	children.insert(children.begin() + index, edge);
+	return child;
+}
+
+
+void
+IgnoreRules::_AddPatternStates(std::vector<int32_t>& states, const Node& node,
+	int32_t key, const char* name, size_t length) const
+{
+	const std::vector<PatternEdge>& edges = node.patternChildren;
+
+	size_t low = 0;
+	size_t high = edges.size();
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+		if (edges[mid].key < key)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	for (size_t i = low; i < edges.size() && edges[i].key == key; i++) {
+		const Node& child = fNodes[edges[i].node];
+		// The literal prefix and suffix have to match, whatever the wildcards
+		// in between match
+		if (child.prefixLength + child.suffixLength > length
+			|| memcmp(child.name.data(), name, child.prefixLength) != 0
+			|| memcmp(child.name.data() + child.name.size() - child.suffixLength,
+				name + length - child.suffixLength, child.suffixLength) != 0)
+			continue;
+
+		if (match_component(child.name, name, length))
+			_AddState(states, edges[i].node);
+	}
+}
+
+
+void
+IgnoreRules::_AddState(std::vector<int32_t>& states, int32_t node) const
+{
+	// A "**" child also matches zero components, so it is active right away
+	while (node >= 0) {
+		if (std::find(states.begin(), states.end(), node) != states.end())
+			return;
+
+		states.push_back(node);
+		node = fNodes[node].anyDepthChild;
+	}
+}
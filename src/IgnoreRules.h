@@ -0,0 +1,84 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+#ifndef IGNORERULES_H
+#define IGNORERULES_H
+
+
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+// The ignore list compiled into a trie of path components, so a path is
+// checked against all rules in a single walk. Directory rules ignore their
+// whole subtree, file rules only the exact path.
+// Patterns share the same trie: components with wildcards become pattern
+// edges, "**" an edge that matches any number of components. Patterns that
+// don't start with a "/" match at any depth, and like directories they
+// ignore everything below what they match.
+// Pattern edges are indexed by the first character of their literal prefix,
+// or else the last one of their literal suffix, so a component is only
+// matched against the few patterns that could match it.
+// It is independent of the IgnoreListView, so the app list builder can use
+// it from its own thread. Callers hold Mutex() with a std::lock_guard while
+// changing or matching.
+// Like the rest of the search engine, it is plain C++ without Kit types.
+
+class IgnoreRules {
+public:
+							IgnoreRules();
+
+	std::mutex&				Mutex() { return fLock; };
+
+	void					MakeEmpty();
+	void					AddRule(const char* path, bool isDirectory);
+	void					AddPattern(const char* pattern);
+	bool					IsEmpty() const { return fRuleCount == 0; };
+
+	bool					Ignores(const char* path) const;
+
+private:
+	struct PatternEdge {
+		int32_t					key;
+		int32_t					node;
+	};
+
+	struct Node {
+		std::string				name;
+		std::vector<int32_t>	children; // sorted by name
+		std::vector<PatternEdge> patternChildren; // sorted by key
+		int32_t					anyDepthChild;
+		uint32_t				prefixLength; // literal parts of a pattern
+		uint32_t				suffixLength;
+		bool					isAnyDepth;
+		bool					ignoresSubtree;
+		bool					ignoresExact;
+	};
+
+	int32_t					_AddNode(const char* name, size_t length);
+	int32_t					_FindChild(int32_t node, const char* name, size_t length,
+								size_t* _insertIndex = NULL) const;
+	int32_t					_AddPatternChild(int32_t node, const char* name,
+								size_t length);
+	void					_AddPatternStates(std::vector<int32_t>& states,
+								const Node& node, int32_t key, const char* name,
+								size_t length) const;
+	void					_AddState(std::vector<int32_t>& states, int32_t node) const;
+
+	std::vector<Node>		fNodes;
+	int32_t					fRuleCount;
+	std::mutex				fLock;
+
+	// scratch space for Ignores(), only used while holding the lock
+	mutable std::vector<int32_t>	fStates;
+	mutable std::vector<int32_t>	fNextStates;
+};
+
+
+#endif // IGNORERULES_H
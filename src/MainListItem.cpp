@@ -13,102 +13,55 @@
 #include <Resources.h>
 
 #include "MainListItem.h"
+#include "MainListView.h"
 #include "QuickLaunch.h"
+#include "Trace.h"
 
 
-MainListItem::MainListItem(BEntry* entry, BString name, int iconSize, bool isFav)
-	:
-	BListItem(),
-	fFavoriteIcon(NULL),
-	fIsNoApp(false)
+// The star is the same for all favorites
+static BBitmap* sFavoriteIcon = NULL;
+
+
+// Fonts and their metrics are the same for all rows, they only change
+// with the plain font
+static const TextStyle&
+text_style()
 {
-	fIconSize = iconSize;
-	fIsFavorite = isFav;
-
-	BNode node;
-	BNodeInfo node_info;
-
-	// try to get node info for this entry
-	if ((node.SetTo(entry) == B_NO_ERROR) && (node_info.SetTo(&node) == B_NO_ERROR)) {
-
-		// cache name and path
-		snprintf(fName, sizeof(fName), "%s", name.String());
-		entry->GetPath(&fPath);
-
-		// check if the favorite is no application
-		if (fIsFavorite) {
-			char mimeString[B_MIME_TYPE_LENGTH];
-			BMimeType nodeType;
-
-			node_info.GetType(mimeString);
-			if (strcasecmp(mimeString, "application/x-vnd.Be-elfexecutable") != 0) {
-				fIsNoApp = true;
-				// In case the non-App favorite is a link,
-				// traverse to the source to get the right icon
-				entry_ref followRef;
-				entry->GetRef(&followRef);
-				BEntry followLink(&followRef, true); // traverse link
-				node.SetTo(&followLink);
-				node_info.SetTo(&node);
-			}
-		}
+	static TextStyle style;
+	if (style.generation != 0 && style.plainFont == *be_plain_font)
+		return style;
 
-		// create bitmap large enough for icon
-		fIcon = new BBitmap(BRect(0, 0, fIconSize, fIconSize), 0, B_RGBA32);
-
-		// cache the icon
-		status_t result = node_info.GetIcon(fIcon, icon_size(fIconSize));
-		if (result != B_OK) {
-			char mimeString[B_MIME_TYPE_LENGTH];
-			BMimeType nodeType;
-
-			if (node_info.GetType(mimeString) != B_OK) {
-				entry_ref ref;
-				entry->GetRef(&ref);
-				if (BMimeType::GuessMimeType(&ref, &nodeType) == B_OK) {
-					strlcpy(mimeString, nodeType.Type(), B_MIME_TYPE_LENGTH);
-					node_info.SetType(nodeType.Type());
-				} else
-					nodeType.SetTo("application/x-vnd.Be-elfexecutable");
-			} else
-				nodeType.SetTo(mimeString);
-
-			result = nodeType.GetIcon(fIcon, icon_size(fIconSize));
-			if (result != B_OK)
-				fIcon = NULL;
-		}
+	style.plainFont = *be_plain_font;
+	style.generation++;
 
-		// if it's a favorite, cache the star icon
-		if (fIsFavorite)
-			SetFavorite(true);
-
-		// cache ref
-		entry->GetRef(&fRef);
-
-		// cache version info
-		BFile file(entry, B_READ_ONLY);
-		if (file.InitCheck() != B_OK)
-			return;
-		BAppFileInfo info(&file);
-		if (info.InitCheck() != B_OK)
-			return;
-		if (info.GetVersionInfo(&fVersionInfo, B_APP_VERSION_KIND) != B_OK) {
-			fVersionInfo.major = 0;
-			fVersionInfo.middle = 0;
-			fVersionInfo.minor = 0;
-		}
+	style.appFont = style.plainFont;
+	style.appFont.GetHeight(&style.appHeight);
+	style.appFont.SetFace(B_BOLD_FACE);
 
-	} else {
-		fIcon = NULL;
-		strcpy(fName, "<Lost File>");
-	}
+	style.pathFont = style.plainFont;
+	style.pathFont.SetSize(style.appFont.Size() * 0.9);
+	style.pathFont.GetHeight(&style.pathHeight);
+
+	return style;
+}
+
+
+MainListItem::MainListItem(AppListItem* entry, int iconSize, bool isFav)
+	:
+	BListItem(),
+	fEntry(entry),
+	fIconSize(iconSize),
+	fIsFavorite(isFav),
+	fPoolNewer(NULL),
+	fPoolOlder(NULL),
+	fPoolNextInBucket(NULL)
+{
+	fLayout.style = 0;
 }
 
 
 MainListItem::~MainListItem()
 {
-	delete fIcon;
-	delete fFavoriteIcon;
 }
 
 
@@ -118,22 +71,37 @@ MainListItem::~MainListItem()
 void
 MainListItem::DrawItem(BView* view, BRect rect, bool complete)
 {
-	QLSettings& settings = my_app->Settings();
-	bool showVersion = settings.GetTempShowVersion();
-	bool showPath = settings.GetTempShowPath();
+	TRACE_SPAN("MainListItem::DrawItem");
+	// In the result list, rows are drawn through its bitmap cache
+	MainListView* listView = dynamic_cast<MainListView*>(view);
+	if (listView != NULL)
+		listView->RowCache().Draw(view, this, rect);
+	else
+		DrawRow(view, rect);
+}
+
+
+void
+MainListItem::Update(BView* owner, const BFont* finfo)
+{
+	// we need to override the update method so we can make sure the
+	// list item size doesn't change
+	BListItem::Update(owner, finfo);
 
 	float spacing = be_control_look->DefaultLabelSpacing();
-	float offset = spacing;
+	SetHeight(fIconSize + spacing + 4);
+}
+
 
-	BFont appfont;
-	font_height appFI;
-	appfont.GetHeight(&appFI);
-	appfont.SetFace(B_BOLD_FACE);
+void
+MainListItem::DrawRow(BView* view, BRect rect)
+{
+	TRACE_SPAN("MainListItem::DrawRow");
+	QLSettings& settings = my_app->Settings();
+	const TextStyle& style = text_style();
+	_UpdateLayout(style, rect, settings.GetTempShowVersion(), settings.GetTempShowPath());
 
-	BFont pathfont;
-	font_height pathFI;
-	pathfont.SetSize(appfont.Size() * 0.9);
-	pathfont.GetHeight(&pathFI);
+	float spacing = be_control_look->DefaultLabelSpacing();
 
 	// set background color
 
@@ -145,7 +113,7 @@ MainListItem::DrawItem(BView* view, BRect rect, bool complete)
 		if (IsFavorite()) {
 			rgb_color favColor = (rgb_color){255, 255, 0, 32};
 			rgb_color noAppColor = (rgb_color){0, 255, 0, 64};
-			bgColor = blend_color(fIsNoApp == true ? noAppColor : favColor, bgColor, 80);
+			bgColor = blend_color(fEntry->IsNoApp() ? noAppColor : favColor, bgColor, 80);
 		}
 	}
 	view->SetHighColor(bgColor);
@@ -154,20 +122,21 @@ MainListItem::DrawItem(BView* view, BRect rect, bool complete)
 
 	// if we have an icon, draw it
 
-	if (fIcon) {
+	BBitmap* icon = Bitmap();
+	if (icon != NULL) {
 		view->PushState();
 		view->SetDrawingMode(B_OP_OVER);
 		view->DrawBitmap(
-			fIcon, BPoint(rect.left + spacing / 2, rect.top + (rect.Height() - fIconSize) / 2));
+			icon, BPoint(rect.left + spacing / 2, rect.top + (rect.Height() - fIconSize) / 2));
 
-		if (fIsFavorite) {
+		BBitmap* favoriteIcon = fIsFavorite ? _FavoriteIcon(fIconSize) : NULL;
+		if (favoriteIcon != NULL) {
 			view->SetBlendingMode(B_PIXEL_ALPHA, B_ALPHA_OVERLAY);
 			view->DrawBitmap(
-				fFavoriteIcon, BPoint(rect.left + fIconSize - spacing - 3,
+				favoriteIcon, BPoint(rect.left + fIconSize - spacing - 3,
 				rect.top + (rect.Height() - fIconSize) / 2 + 4));
 		}
 		view->PopState();
-		offset = fIcon->Bounds().Width() + offset + spacing;
 	}
 
 	// application name
@@ -176,30 +145,12 @@ MainListItem::DrawItem(BView* view, BRect rect, bool complete)
 	else
 		view->SetHighColor(ui_color(B_LIST_ITEM_TEXT_COLOR));
 
-	view->SetFont(&appfont);
-
-	if (!showPath && fIsNoApp) {
-		view->MovePenTo(offset, floor(rect.top + appFI.ascent
-		+ (rect.Height() + 1 - (appFI.ascent + appFI.descent))
-		/ 2));
-	} else if (showVersion || showPath) {
-		view->MovePenTo(offset, floor(rect.top + appFI.ascent + 1
-		+ (rect.Height() + 1 - (appFI.ascent + appFI.descent + pathFI.ascent + pathFI.descent))
-		/ 2));
-	} else {
-		view->MovePenTo(offset, floor(rect.top + appFI.ascent
-		+ (rect.Height() + 1 - (appFI.ascent + appFI.descent))
-		/ 2));
-	}
-
-	float width, height;
-	view->GetPreferredSize(&width, &height);
-	BString string(fName);
-	view->TruncateString(&string, B_TRUNCATE_MIDDLE, width - fIconSize - offset / 2);
-	view->DrawString(string.String());
+	view->SetFont(&style.appFont);
+	view->DrawString(fLayout.name.String(),
+		BPoint(fLayout.textOffset, rect.top + fLayout.nameBaseline));
 
 	// application path and version
-	if (showVersion || showPath) {
+	if (fLayout.showDetails) {
 		if (IsSelected()) {
 			view->SetHighColor(tint_color(ui_color(B_LIST_SELECTED_ITEM_TEXT_COLOR),
 				ui_color(B_LIST_SELECTED_ITEM_TEXT_COLOR).IsDark() ?
@@ -210,36 +161,9 @@ MainListItem::DrawItem(BView* view, BRect rect, bool complete)
 				B_LIGHTEN_1_TINT : B_DARKEN_1_TINT));
 		}
 
-		view->SetFont(&pathfont);
-		view->MovePenTo(offset, floor(rect.top + appFI.ascent + 2 + pathFI.ascent
-			+ (rect.Height() + 1
-				- (appFI.ascent + appFI.descent + 1 + pathFI.ascent + pathFI.descent))
-			/ 2));
-
-		BPath parent;
-		fPath.GetParent(&parent);
-		string = "";
-
-		char text[256];
-
-		if (showVersion && !fIsNoApp) {
-			snprintf(text, sizeof(text), "%" B_PRId32, fVersionInfo.major);
-			string << "v" << text << ".";
-			snprintf(text, sizeof(text), "%" B_PRId32, fVersionInfo.middle);
-			string << text << ".";
-			snprintf(text, sizeof(text), "%" B_PRId32, fVersionInfo.minor);
-			string << text;
-		}
-		if (showVersion && showPath && !fIsNoApp)
-			string << " - ";
-
-		if (showPath) {
-			string << parent.Path();
-			string << "/";
-		}
-
-		view->TruncateString(&string, B_TRUNCATE_MIDDLE, width - fIconSize - offset / 2);
-			view->DrawString(string.String());
+		view->SetFont(&style.pathFont);
+		view->DrawString(fLayout.details.String(),
+			BPoint(fLayout.textOffset, rect.top + fLayout.detailsBaseline));
 	}
 	// draw lines
 
@@ -250,29 +174,114 @@ MainListItem::DrawItem(BView* view, BRect rect, bool complete)
 
 
 void
-MainListItem::Update(BView* owner, const BFont* finfo)
+MainListItem::SetEntry(AppListItem* entry)
 {
-	// we need to override the update method so we can make sure the
-	// list item size doesn't change
-	BListItem::Update(owner, finfo);
-
-	float spacing = be_control_look->DefaultLabelSpacing();
-	SetHeight(fIcon->Bounds().Height() + spacing + 4);
+	// The name and details shown may have changed with the entry
+	fEntry.SetTo(entry);
+	fLayout.style = 0;
 }
 
 
 void
 MainListItem::SetFavorite(bool state)
 {
-	if (state && fFavoriteIcon == NULL) {
-		size_t size;
-		const void* buf
-			= be_app->AppResources()->LoadResource(B_VECTOR_ICON_TYPE, "FavoriteStar", &size);
-
-		if (buf != NULL) {
-			fFavoriteIcon = new BBitmap(BRect(0, 0, fIconSize, fIconSize), B_RGBA32);
-			BIconUtils::GetVectorIcon((const uint8*)buf, size, fFavoriteIcon);
-		}
-	}
 	fIsFavorite = state;
 }
+
+
+#pragma mark-- Private Methods --
+
+
+void
+MainListItem::_UpdateLayout(const TextStyle& style, BRect rect, bool showVersion,
+	bool showPath)
+{
+	// Positions and truncated strings only depend on these, drawing the row
+	// again (e.g. when scrolling or selecting) just uses them
+	if (fLayout.style == style.generation && fLayout.width == rect.Width()
+		&& fLayout.height == rect.Height() && fLayout.showVersion == showVersion
+		&& fLayout.showPath == showPath)
+		return;
+
+	fLayout.style = style.generation;
+	fLayout.width = rect.Width();
+	fLayout.height = rect.Height();
+	fLayout.showVersion = showVersion;
+	fLayout.showPath = showPath;
+
+	const font_height& appFI = style.appHeight;
+	const font_height& pathFI = style.pathHeight;
+
+	float spacing = be_control_look->DefaultLabelSpacing();
+	float offset = spacing;
+	BBitmap* icon = Bitmap();
+	if (icon != NULL)
+		offset = icon->Bounds().Width() + offset + spacing;
+	fLayout.textOffset = offset;
+
+	bool isNoApp = fEntry->IsNoApp();
+	fLayout.showDetails = showVersion || showPath;
+
+	if (!showPath && isNoApp) {
+		fLayout.nameBaseline = floor(appFI.ascent
+			+ (rect.Height() + 1 - (appFI.ascent + appFI.descent)) / 2);
+	} else if (fLayout.showDetails) {
+		fLayout.nameBaseline = floor(appFI.ascent + 1
+			+ (rect.Height() + 1
+				- (appFI.ascent + appFI.descent + pathFI.ascent + pathFI.descent))
+			/ 2);
+	} else {
+		fLayout.nameBaseline = floor(appFI.ascent
+			+ (rect.Height() + 1 - (appFI.ascent + appFI.descent)) / 2);
+	}
+
+	float textWidth = rect.Width() - fIconSize - offset / 2;
+	fLayout.name = GetName();
+	style.appFont.TruncateString(&fLayout.name, B_TRUNCATE_MIDDLE, textWidth);
+
+	fLayout.details = "";
+	if (!fLayout.showDetails)
+		return;
+
+	fLayout.detailsBaseline = floor(appFI.ascent + 2 + pathFI.ascent
+		+ (rect.Height() + 1
+			- (appFI.ascent + appFI.descent + 1 + pathFI.ascent + pathFI.descent))
+		/ 2);
+
+	if (showVersion && !isNoApp) {
+		const version_info& versionInfo = fEntry->Version();
+		fLayout.details.SetToFormat("v%" B_PRId32 ".%" B_PRId32 ".%" B_PRId32,
+			versionInfo.major, versionInfo.middle, versionInfo.minor);
+	}
+	if (showVersion && showPath && !isNoApp)
+		fLayout.details << " - ";
+
+	if (showPath) {
+		// The parent folder, including the trailing slash
+		const BString& path = fEntry->GetPath();
+		fLayout.details.Append(path, path.FindLast('/') + 1);
+	}
+
+	style.pathFont.TruncateString(&fLayout.details, B_TRUNCATE_MIDDLE, textWidth);
+}
+
+
+/*static*/ BBitmap*
+MainListItem::_FavoriteIcon(int iconSize)
+{
+	if (sFavoriteIcon != NULL && sFavoriteIcon->Bounds().IntegerWidth() == iconSize)
+		return sFavoriteIcon;
+
+	delete sFavoriteIcon;
+	sFavoriteIcon = NULL;
+
+	size_t size;
+	const void* buf
+		= be_app->AppResources()->LoadResource(B_VECTOR_ICON_TYPE, "FavoriteStar", &size);
+
+	if (buf != NULL) {
+		sFavoriteIcon = new BBitmap(BRect(0, 0, iconSize, iconSize), B_RGBA32);
+		BIconUtils::GetVectorIcon((const uint8*)buf, size, sFavoriteIcon);
+	}
+	return sFavoriteIcon;
+}
@@ -9,46 +9,97 @@
 #ifndef QLLISTITEM_H
 #define QLLISTITEM_H
 
-#include <AppFileInfo.h>
+#include "AppListItem.h"
+
 #include <Bitmap.h>
 #include <Entry.h>
-#include <File.h>
 #include <Font.h>
 #include <InterfaceDefs.h>
 #include <ListItem.h>
-#include <MenuItem.h>
-#include <Node.h>
-#include <NodeInfo.h>
-#include <Path.h>
+#include <Referenceable.h>
 #include <String.h>
 
 #include <stdlib.h>
 
+
+// Rows are identified by their entry, this hashes an entry_ref for lookups
+struct EntryRefHash {
+	size_t operator()(const entry_ref& ref) const
+	{
+		size_t hash = size_t(ref.device) * 31 + size_t(ref.directory);
+		for (const char* c = ref.name; c != NULL && *c != '\0'; c++)
+			hash = hash * 31 + *c;
+		return hash;
+	}
+};
+
+
+// Fonts and metrics for drawing rows, shared by all of them
+struct TextStyle {
+	BFont		plainFont;
+	int32		generation;
+	BFont		appFont;
+	font_height	appHeight;
+	BFont		pathFont;
+	font_height	pathHeight;
+
+				TextStyle() : generation(0) {};
+};
+
+
+// A row of the results. The entry's data is shared with the app list (or,
+// for favorites, with the other rows of the same favorite), so all a row
+// holds is the reference and how it's shown.
+
 class MainListItem : public BListItem {
 public:
-					MainListItem(BEntry* entry, BString name, int iconSize,	bool isFav = false);
+					MainListItem(AppListItem* entry, int iconSize, bool isFav = false);
 					~MainListItem();
 
 	virtual void	DrawItem(BView*, BRect, bool);
 	virtual	void	Update(BView*, const BFont*);
+	void			DrawRow(BView* view, BRect rect);
 
-	BBitmap*		Bitmap() { return fIcon; };
-	char*			GetName() { return fName; };
-	entry_ref*		Ref() { return &fRef; };
-	const BPath&	Path() { return fPath; };
+	AppListItem*	Entry() { return fEntry.Get(); };
+	void			SetEntry(AppListItem* entry);
+	BBitmap*		Bitmap() { return fEntry->Icon(fIconSize); };
+	const char*		GetName() { return fEntry->GetName().String(); };
+	entry_ref*		Ref() { return fEntry->GetRef(); };
 	bool			IsFavorite() { return fIsFavorite; };
 	void			SetFavorite(bool state);
 
 private:
-	char			fName[B_FILE_NAME_LENGTH];
-	entry_ref		fRef;
-	BPath			fPath;
-	version_info	fVersionInfo;
-	BBitmap*		fIcon;
-	BBitmap*		fFavoriteIcon;
+	void			_UpdateLayout(const TextStyle& style, BRect rect,
+						bool showVersion, bool showPath);
+	static BBitmap*	_FavoriteIcon(int iconSize);
+
+	// What was computed for drawing the row the last time, valid as long
+	// as the first five are the same
+	struct Layout {
+		int32		style;
+		float		width;
+		float		height;
+		bool		showVersion;
+		bool		showPath;
+		bool		showDetails;
+		float		textOffset;
+		float		nameBaseline;
+		float		detailsBaseline;
+		BString		name;
+		BString		details;
+	};
+
+	BReference<AppListItem>	fEntry;
 	int				fIconSize;
 	bool			fIsFavorite;
-	bool			fIsNoApp;
+	Layout			fLayout;
+
+	// Links while the row waits in the RowPool, so pooling it allocates
+	// nothing
+	friend class RowPool;
+	MainListItem*	fPoolNewer;
+	MainListItem*	fPoolOlder;
+	MainListItem*	fPoolNextInBucket;
 };
 
 #endif // QLLISTITEM_H
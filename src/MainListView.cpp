@@ -12,12 +12,18 @@
 #include "MainWindow.h"
 #include "QLFilter.h"
 #include "QuickLaunch.h"
+#include "Trace.h"
 
 #include <Catalog.h>
 
 #undef B_TRANSLATION_CONTEXT
 #define B_TRANSLATION_CONTEXT "ListView"
 
+
+// Enough for the visible rows, each selected and not, and some scrolling
+static const int32 kMaxCachedRows = 64;
+
+
 class PopUpMenu : public BPopUpMenu
 {
 public:
@@ -49,7 +55,8 @@ MainListView::MainListView()
 	BListView("ResultList"),
 	fShowingPopUpMenu(false),
 	fPrimaryButton(false),
-	fDropRect()
+	fDropRect(),
+	fRowCache(kMaxCachedRows)
 {
 }
 
@@ -66,6 +73,7 @@ MainListView::~MainListView()
 void
 MainListView::Draw(BRect rect)
 {
+	TRACE_SPAN("MainListView::Draw");
 	MainWindow* window = dynamic_cast<MainWindow*>(Window());
 	bool emptySearch = window->IsFavoritesOnly();
 	float width, height;
@@ -110,10 +118,8 @@ MainListView::FrameResized(float w, float h)
 {
 	BListView::FrameResized(w, h);
 
-	for (int32 i = 0; i < CountItems(); i++) {
-		BListItem* item = ItemAt(i);
-		item->Update(this, be_plain_font);
-	}
+	// The rows' layout and rendered bitmaps are keyed on the width they're
+	// drawn with, redrawing is all a new width needs
 	Invalidate();
 }
 
@@ -290,6 +296,15 @@ MainListView::MessageReceived(BMessage* message)
 			}
 			break;
 		}
+		case B_COLORS_UPDATED:
+		case B_FONTS_UPDATED:
+		{
+			// Cached rows were rendered with the old ones
+			fRowCache.MakeEmpty();
+			Invalidate();
+			BView::MessageReceived(message);
+			break;
+		}
 		default:
 			BView::MessageReceived(message);
 			break;
@@ -401,6 +416,29 @@ MainListView::MakeEmpty()
 }
 
 
+void
+MainListView::DetachItems(BList& items)
+{
+	// Hands the current items over to the caller, who owns them from now on
+	for (int32 i = 0; i < CountItems(); i++)
+		items.AddItem(ItemAt(i));
+
+	BListView::MakeEmpty();
+}
+
+
+void
+MainListView::ReplaceItems(const BList& items)
+{
+	// Unlike MakeEmpty(), this doesn't delete the current items, the caller
+	// keeps track of those it doesn't reuse
+
+	BListView::MakeEmpty();
+	AddList(const_cast<BList*>(&items));
+	Invalidate();
+}
+
+
 #pragma mark-- Private Methods --
 
 
@@ -9,6 +9,8 @@
 #ifndef QLLISTVIEW_H
 #define QLLISTVIEW_H
 
+#include "RowBitmapCache.h"
+
 #include <ListView.h>
 #include <MenuItem.h>
 #include <PopUpMenu.h>
@@ -37,6 +39,10 @@ public:
 	virtual	void 	MouseMoved(BPoint where, uint32 transit,
 						const BMessage* dragMessage);
 	virtual void	MakeEmpty();
+	void			DetachItems(BList& items);
+	void			ReplaceItems(const BList& items);
+
+	RowBitmapCache&	RowCache() { return fRowCache; };
 
 private:
 	void			_ShowPopUpMenu(BPoint screen);
@@ -45,6 +51,7 @@ private:
 	bool			fPrimaryButton;
 	int32			fCurrentItemIndex;
 	BRect			fDropRect;
+	RowBitmapCache	fRowCache;
 
 };
 
@@ -15,6 +15,7 @@
 #include "IconMenuItem.h"
 #include "QLFilter.h"
 #include "QuickLaunch.h"
+#include "Trace.h"
 
 #include <Catalog.h>
 #include <ControlLook.h>
@@ -33,33 +34,16 @@ extern const char* kApplicationName;
 #define B_TRANSLATION_CONTEXT "MainWindow"
 
 
-static int
-compare_items(const void* a, const void* b)
-{
-	MainListItem* stringA = *(MainListItem**)a;
-	MainListItem* stringB = *(MainListItem**)b;
-
-	int cmp = strcasecmp(stringA->GetName(), stringB->GetName());
-	if (cmp != 0)
-		return cmp;
-
-	return strcasecmp(stringA->Path().Path(), stringB->Path().Path());
-}
-
-
-static int
-compare_favorite_items(const void* a, const void* b)
-{
-	MainListItem* stringA = *(MainListItem**)a;
-	MainListItem* stringB = *(MainListItem**)b;
+// What the next frame has to bring up to date, see _ScheduleUpdate()
+enum {
+	kUpdateAppended	= 0x01,
+	kUpdateHeight	= 0x02,
+	kUpdateList		= 0x04,
+	kUpdateScroll	= 0x08
+};
 
-	if (stringA->IsFavorite() && !stringB->IsFavorite())
-		return -1;
-	else if (stringB->IsFavorite() && !stringA->IsFavorite())
-		return 1;
-
-	return compare_items(a, b);
-}
+// Appended results are shown at most this many rows per frame
+static const size_t kAppendedRowsPerFrame = 256;
 
 
 MainWindow::MainWindow()
@@ -67,17 +51,25 @@ MainWindow::MainWindow()
 	BWindow(BRect(), B_TRANSLATE_SYSTEM_NAME(kApplicationName), B_TITLED_WINDOW_LOOK,
 		B_FLOATING_ALL_WINDOW_FEEL,
 		B_NOT_ZOOMABLE | B_ASYNCHRONOUS_CONTROLS | B_QUIT_ON_WINDOW_CLOSE | B_FRAME_EVENTS
-			| B_AUTO_UPDATE_SIZE_LIMITS | B_CLOSE_ON_ESCAPE)
+			| B_AUTO_UPDATE_SIZE_LIMITS | B_CLOSE_ON_ESCAPE),
+	fRowPool(kMAX_POOLED_ROWS),
+	fNewRows(kMAX_POOLED_ROWS)
 {
+	TRACE_SPAN("MainWindow::MainWindow");
 	fAppList = new AppList();
 	fAppList->StartWatching(this, BUILDAPPLIST);
+	fSearchWorker = new SearchWorker(fAppList, BMessenger(this));
+	fSearchGeneration = 0;
+	fLoading = false;
+	fAppendQueue.reserve(64);
+	fAppendedRows = 0;
+	fPendingUpdates = 0;
+	fShownRowCount = -1;
 
 	fIconHeight = (int32(be_control_look->ComposeIconSize(B_LARGE_ICON).Height()) + 2);
 
 	QLSettings& settings = my_app->Settings();
-	fSetupWindow = new SetupWindow(settings.GetSetupWindowFrame(), this);
-	fSetupWindow->Hide();
-	fSetupWindow->Show();
+	fSetupWindow = NULL;
 
 	BMenuBar* menubar = new BMenuBar("mainmenu");
 	BMenuItem* item;
@@ -93,7 +85,10 @@ MainWindow::MainWindow()
 	item->SetTarget(be_app);
 	menu->AddItem(item);
 	menu->AddSeparatorItem();
-	menu->AddItem(new BMenuItem(B_TRANSLATE("Quit"), new BMessage(B_QUIT_REQUESTED), 'Q'));
+	// Quits the app, even when closing the window only hides it
+	item = new BMenuItem(B_TRANSLATE("Quit"), new BMessage(B_QUIT_REQUESTED), 'Q');
+	item->SetTarget(be_app);
+	menu->AddItem(item);
 
 	menubar->AddItem(new IconMenuItem(menu, NULL, kApplicationSignature, B_MINI_ICON));
 
@@ -163,15 +158,23 @@ MainWindow::MainWindow()
 	fListView->SetInvocationMessage(new BMessage(RETURN_KEY));
 	fListView->SetViewColor(B_TRANSPARENT_COLOR);
 
+	// The window gets its size from the first results, don't wait for a
+	// frame with that
 	_RebuildResults();
+	_ApplyUpdates();
 }
 
 
 MainWindow::~MainWindow()
 {
+	fSearchWorker->Lock();
+	fSearchWorker->Quit();
+
 	fAppList->Lock();
 	fAppList->Quit();
 
+	_DropAppended();
+
 	QLSettings& settings = my_app->Settings();
 	if (settings.Lock()) {
 		settings.SetSearchTerm(GetSearchString());
@@ -212,74 +215,13 @@ MainWindow::MessageReceived(BMessage* message)
 
 	switch (message->what) {
 		case CURSOR_UP:
-		{
-			int selection = fListView->CurrentSelection();
-			int last = fListView->IndexOf(fListView->LastItem());
-			if (selection != 0)
-				fListView->Select(selection - 1);
-			else
-				fListView->Select(last);
-
-			fListView->ScrollToSelection();
-			break;
-		}
 		case CURSOR_DOWN:
-		{
-			int selection = fListView->CurrentSelection();
-			int last = fListView->IndexOf(fListView->LastItem());
-			int first = fListView->IndexOf(fListView->FirstItem());
-			if (selection != last)
-				fListView->Select(selection + 1);
-			else
-				fListView->Select(first);
-
-			fListView->ScrollToSelection();
-			break;
-		}
 		case PAGE_UP:
-		{
-			int selection = fListView->CurrentSelection();
-			int first = fListView->IndexOf(fListView->FirstItem());
-
-			if (selection > kMAX_DISPLAYED_ITEMS) {
-				fListView->Select(selection - kMAX_DISPLAYED_ITEMS + 1);
-				fListView->ScrollBy(0.0,
-					-(kMAX_DISPLAYED_ITEMS - 1) * fListView->ItemFrame(0).Height()
-						- kMAX_DISPLAYED_ITEMS + 1);
-			} else
-				fListView->Select(first);
-
-			fListView->ScrollToSelection();
-			break;
-		}
 		case PAGE_DOWN:
-		{
-			int selection = fListView->CurrentSelection();
-			int last = fListView->IndexOf(fListView->LastItem());
-
-			if (selection < (fListView->CountItems() - kMAX_DISPLAYED_ITEMS)) {
-				fListView->Select(selection + kMAX_DISPLAYED_ITEMS - 1);
-				fListView->ScrollBy(0.0,
-					(kMAX_DISPLAYED_ITEMS - 1) * fListView->ItemFrame(0).Height()
-						+ kMAX_DISPLAYED_ITEMS - 1);
-			} else
-				fListView->Select(last);
-			break;
-		}
 		case HOME:
-		{
-			if (fListView->IsEmpty() == 0)
-				fListView->Select(0);
-
-			fListView->ScrollToSelection();
-			break;
-		}
 		case END:
 		{
-			if (fListView->IsEmpty() == 0)
-				fListView->Select(fListView->IndexOf(fListView->LastItem()));
-
-			fListView->ScrollToSelection();
+			Navigate(message->what, 1);
 			break;
 		}
 		case RETURN_CTRL_KEY:
@@ -325,7 +267,7 @@ MainWindow::MessageReceived(BMessage* message)
 				settings.Unlock();
 			}
 
-			be_app->PostMessage(B_QUIT_REQUESTED);
+			_Close();
 			break;
 		}
 		case RETURN_SHIFT_KEY:
@@ -353,7 +295,7 @@ MainWindow::MessageReceived(BMessage* message)
 				settings.Unlock();
 			}
 
-			be_app->PostMessage(B_QUIT_REQUESTED);
+			_Close();
 			break;
 		}
 		case ADD_REMOVE_FAVORITE:
@@ -365,7 +307,8 @@ MainWindow::MessageReceived(BMessage* message)
 		}
 		case B_REFS_RECEIVED:
 		{
-			fSetupWindow->MessageReceived(message);
+			// The settings window handles the refs in its own thread
+			_SetupWindow()->PostMessage(message);
 			break;
 		}
 		case NEW_FILTER:
@@ -373,6 +316,45 @@ MainWindow::MessageReceived(BMessage* message)
 			_RebuildResults();
 			break;
 		}
+		case SEARCH_RESULTS:
+		{
+			SearchResults* results = NULL;
+			if (message->FindPointer("results", (void**)&results) != B_OK)
+				break;
+
+			// Only show the results if nothing was typed since the search started
+			if (message->GetInt32("generation", -1) != fSearchGeneration) {
+				fSearchWorker->Recycle(results);
+				break;
+			}
+
+			// The first chunk replaces the shown results right away, so the
+			// first page is painted on its own. The others are appended below
+			// it a few rows per frame, without touching the selection.
+			if (message->GetBool("first", true))
+				_ShowResults(results);
+			else
+				_QueueAppended(results);
+
+			_SetLoading(!message->GetBool("last", true));
+			break;
+		}
+		case SHOW_WINDOW:
+		{
+			// The results were kept up to date while hidden
+			if (IsHidden())
+				Show();
+
+			Activate();
+			fSearchBox->MakeFocus(true);
+			fSearchBox->TextView()->SelectAll();
+			break;
+		}
+		case UPDATE_UI:
+		{
+			_ApplyUpdates();
+			break;
+		}
 		case B_SIMPLE_DATA:
 		{
 			if (fSearchBox->TextLength() == 0)
@@ -381,15 +363,16 @@ MainWindow::MessageReceived(BMessage* message)
 		}
 		case SETUP_MENU:
 		{
-			if (fSetupWindow->IsHidden()) {
+			BWindow* setupWindow = _SetupWindow();
+			if (setupWindow->IsHidden()) {
 				SetFeel(B_NORMAL_WINDOW_FEEL);
 				BRect rect = Frame().OffsetBySelf(fIconHeight * 4, fIconHeight);
-				fSetupWindow->MoveTo(rect.LeftTop());
-				fSetupWindow->MoveOnScreen(B_MOVE_IF_PARTIALLY_OFFSCREEN);
-				fSetupWindow->Show();
+				setupWindow->MoveTo(rect.LeftTop());
+				setupWindow->MoveOnScreen(B_MOVE_IF_PARTIALLY_OFFSCREEN);
+				setupWindow->Show();
 			} else {
 				SetFeel(B_FLOATING_ALL_WINDOW_FEEL);
-				fSetupWindow->Hide();
+				setupWindow->Hide();
 			}
 			break;
 		}
@@ -403,7 +386,7 @@ MainWindow::MessageReceived(BMessage* message)
 
 			settings.SetTempShowVersion(value);
 			fTempShowVersion->SetMarked(value);
-			fListView->Invalidate();
+			_ScheduleUpdate(kUpdateList);
 			break;
 		}
 		case PATH_CHK:
@@ -416,7 +399,7 @@ MainWindow::MessageReceived(BMessage* message)
 
 			settings.SetTempShowPath(value);
 			fTempShowPath->SetMarked(value);
-			fListView->Invalidate();
+			_ScheduleUpdate(kUpdateList);
 			break;
 		}
 		case SEARCHSTART_CHK:
@@ -455,12 +438,21 @@ MainWindow::MessageReceived(BMessage* message)
 
 			settings.SetTempShowIgnore(value);
 			fTempApplyIgnore->SetMarked(value);
-			// intentional fall-thru to BUILDAPPLIST
 
+			// The ignore list is only a mask over the app list, no need to rebuild
+			if (!IsFavoritesOnly())
+				_RebuildResults();
+			break;
+		}
+		case IGNORELIST_CHANGED:
+		case B_LOCALE_CHANGED:
+		{
+			fAppList->PostMessage(message);
+			break;
 		}
 		case BUILDAPPLIST:
 		{
-			fAppList->PostMessage(BUILDAPPLIST);
+			fAppList->Rebuild();
 			break;
 		}
 		case B_OBSERVER_NOTICE_CHANGE:
@@ -489,7 +481,11 @@ MainWindow::MessageReceived(BMessage* message)
 bool
 MainWindow::QuitRequested()
 {
-	return true;
+	if (!my_app->Settings().GetResident())
+		return true;
+
+	_HideToBackground();
+	return false;
 }
 
 
@@ -497,16 +493,80 @@ MainWindow::QuitRequested()
 
 
 void
-MainWindow::ResultsCountChanged()
+MainWindow::Navigate(uint32 command, int32 count)
 {
-	int32 count = fListView->CountItems();
-	count = (count < kMAX_DISPLAYED_ITEMS) ? count : kMAX_DISPLAYED_ITEMS;
-	BRect itemRect = fListView->ItemFrame(0);
-	float itemHeight = itemRect.Height();
-	float windowRest = Frame().Height() - fListView->Frame().Height();
-	ResizeTo(Bounds().Width(), count * itemHeight + windowRest + count - 2);
+	// Moves the selection as if the key for command was pressed count times
+	int32 itemCount = fListView->CountItems();
+	if (itemCount == 0 || count <= 0)
+		return;
 
-	fSelectionMenu->SetEnabled(!fListView->IsEmpty());
+	int32 selection = fListView->CurrentSelection();
+	int32 last = itemCount - 1;
+	int32 page = kMAX_DISPLAYED_ITEMS - 1;
+	float pageHeight = page * fListView->ItemFrame(0).Height() + page;
+
+	switch (command) {
+		case CURSOR_UP:
+		case CURSOR_DOWN:
+		{
+			// Moving past either end wraps around
+			if (selection < 0)
+				selection = command == CURSOR_UP ? itemCount : -1;
+
+			int32 delta = command == CURSOR_UP ? -count : count;
+			selection = (selection + delta) % itemCount;
+			if (selection < 0)
+				selection += itemCount;
+
+			fListView->Select(selection);
+			fListView->ScrollToSelection();
+			break;
+		}
+		case PAGE_UP:
+		{
+			for (int32 i = 0; i < count; i++) {
+				if (selection > kMAX_DISPLAYED_ITEMS) {
+					selection -= page;
+					fListView->ScrollBy(0.0, -pageHeight);
+				} else
+					selection = 0;
+			}
+			fListView->Select(selection);
+			fListView->ScrollToSelection();
+			break;
+		}
+		case PAGE_DOWN:
+		{
+			for (int32 i = 0; i < count; i++) {
+				if (selection < itemCount - kMAX_DISPLAYED_ITEMS) {
+					selection += page;
+					fListView->ScrollBy(0.0, pageHeight);
+				} else
+					selection = last;
+			}
+			fListView->Select(selection);
+			break;
+		}
+		case HOME:
+		{
+			fListView->Select(0);
+			fListView->ScrollToSelection();
+			break;
+		}
+		case END:
+		{
+			fListView->Select(last);
+			fListView->ScrollToSelection();
+			break;
+		}
+	}
+}
+
+
+void
+MainWindow::ResultsCountChanged()
+{
+	_ScheduleUpdate(kUpdateHeight);
 }
 
 
@@ -516,91 +576,296 @@ MainWindow::ResultsCountChanged()
 void
 MainWindow::_RebuildResults()
 {
-	int32 selection = fListView->CurrentSelection();
-	entry_ref ref;
-	if (selection >= 0)
-		ref = *dynamic_cast<MainListItem*>(fListView->ItemAt(selection))->Ref();
+	// The search runs on the SearchWorker, the results are shown when
+	// they arrive with a SEARCH_RESULTS message if they are still current.
+	// Starting a new search or showing the favorites makes older ones obsolete.
+	// Rows still to be appended belong to the older ones.
+	_DropAppended();
+
+	if (IsFavoritesOnly()) {
+		fSearchGeneration = fSearchWorker->Cancel();
+
+		SearchResults* favorites = fSearchWorker->NewResults();
+		_GetFavorites(*favorites);
+		_ShowResults(favorites);
+		_SetLoading(false);
+		return;
+	}
 
-	fListView->MakeEmpty();
+	QLSettings& settings = my_app->Settings();
+	fSearchGeneration = fSearchWorker->Search(GetSearchString(),
+		settings.GetTempSearchStart() == 1, settings.GetTempApplyIgnore(),
+		settings.GetSortFavorites(), kMAX_DISPLAYED_ITEMS);
+}
 
-	if (IsFavoritesOnly())
-		_ShowFavorites();
-	else
-		_FilterAppList();
 
-	if (selection >= 0) {
-		int32 count = fListView->CountItems();
-		for (int32 i = 0; i < count; i++) {
-			if (ref == *dynamic_cast<MainListItem*>(fListView->ItemAt(i))->Ref()) {
-				selection = i;
-				break;
-			}
-		}
-		fListView->Select((selection < count) ? selection : count - 1);
-	} else if (!fListView->IsEmpty())
+void
+MainWindow::_UpdateResults(const SearchResults& results)
+{
+	// Only the difference to the shown results is applied: rows of entries
+	// that are still there are kept (with their icons), the others are
+	// taken from the row pool or created, and the view gets all of them in
+	// one go. The shown rows are taken out of the view before they go to
+	// the pool, and the pool is only trimmed when the view has its new
+	// rows, so it never deletes one that's shown. They're put back from the
+	// bottom up, so trimming keeps the top ones, which are most likely to
+	// be shown again.
+	int32 selection = fListView->CurrentSelection();
+	MainListItem* selected = dynamic_cast<MainListItem*>(fListView->ItemAt(selection));
+	// The selected row itself may be deleted meanwhile, its entry isn't
+	BReference<AppListItem> selectedEntry(selected != NULL ? selected->Entry() : NULL);
+
+	fListView->DetachItems(fNewRows);
+	for (int32 i = fNewRows.CountItems() - 1; i >= 0; i--)
+		fRowPool.Put(static_cast<MainListItem*>(fNewRows.ItemAtFast(i)));
+	fNewRows.MakeEmpty();
+
+	size_t count = results.items.size();
+	int32 newSelection = -1;
+	for (size_t i = 0; i < count; i++) {
+		MainListItem* item = _TakeRow(results.items[i]);
+		if (item == NULL)
+			continue;
+		if (newSelection < 0 && selectedEntry.Get() != NULL
+			&& *item->Ref() == *selectedEntry->GetRef())
+			newSelection = fNewRows.CountItems();
+		fNewRows.AddItem(item);
+	}
+	fListView->ReplaceItems(fNewRows);
+	fNewRows.MakeEmpty();
+	fRowPool.Trim();
+
+	int32 itemCount = fListView->CountItems();
+	if (newSelection >= 0)
+		fListView->Select(newSelection);
+	else if (selection >= 0)
+		fListView->Select((selection < itemCount) ? selection : itemCount - 1);
+	else if (itemCount > 0)
 		fListView->Select(0);
+}
+
+
+void
+MainWindow::_ShowResults(SearchResults* results)
+{
+	// Appended results that weren't shown yet are outdated
+	_DropAppended();
 
-	ResultsCountChanged();
+	_UpdateResults(*results);
+	fSearchWorker->Recycle(results);
+
+	_UpdateHeight();
 	fListView->ScrollToSelection();
 }
 
 
 void
-MainWindow::_FilterAppList()
+MainWindow::_QueueAppended(SearchResults* results)
+{
+	fAppendQueue.push_back(results);
+	_ScheduleUpdate(kUpdateAppended);
+}
+
+
+void
+MainWindow::_AppendQueued()
+{
+	// However many chunks arrived, a frame only creates a bounded number
+	// of rows. What's left is appended with the next frame.
+	size_t rows = 0;
+	while (!fAppendQueue.empty() && rows < kAppendedRowsPerFrame) {
+		SearchResults* results = fAppendQueue.front();
+		size_t end = std::min(results->items.size(),
+			fAppendedRows + kAppendedRowsPerFrame - rows);
+		for (size_t i = fAppendedRows; i < end; i++) {
+			MainListItem* item = _TakeRow(results->items[i]);
+			if (item != NULL)
+				fNewRows.AddItem(item);
+		}
+		rows += end - fAppendedRows;
+		fAppendedRows = end;
+
+		if (fAppendedRows == results->items.size()) {
+			fAppendQueue.erase(fAppendQueue.begin());
+			fSearchWorker->Recycle(results);
+			fAppendedRows = 0;
+		}
+	}
+	fListView->AddList(&fNewRows);
+	fNewRows.MakeEmpty();
+
+	if (!fAppendQueue.empty())
+		_ScheduleUpdate(kUpdateAppended);
+}
+
+
+void
+MainWindow::_DropAppended()
+{
+	for (size_t i = 0; i < fAppendQueue.size(); i++)
+		fSearchWorker->Recycle(fAppendQueue[i]);
+	fAppendQueue.clear();
+	fAppendedRows = 0;
+}
+
+
+void
+MainWindow::_ScheduleUpdate(uint32 updates)
+{
+	// Changes are collected and applied together with a single UPDATE_UI.
+	// It's handled after whatever is already waiting in the queue, so a
+	// burst of keystrokes or result chunks only updates the window once, and
+	// input and drawing get their turn between two frames of appended rows.
+	bool scheduled = fPendingUpdates != 0;
+	fPendingUpdates |= updates;
+	if (!scheduled && PostMessage(UPDATE_UI) != B_OK)
+		_ApplyUpdates();
+}
+
+
+void
+MainWindow::_ApplyUpdates()
+{
+	TRACE_SPAN("MainWindow::_ApplyUpdates");
+	uint32 updates = fPendingUpdates;
+	fPendingUpdates = 0;
+
+	if ((updates & kUpdateAppended) != 0 && !fAppendQueue.empty()) {
+		_AppendQueued();
+		updates |= kUpdateHeight;
+	}
+
+	if ((updates & kUpdateHeight) != 0)
+		_UpdateHeight();
+
+	if ((updates & kUpdateList) != 0)
+		fListView->Invalidate();
+
+	if ((updates & kUpdateScroll) != 0)
+		fListView->ScrollToSelection();
+}
+
+
+void
+MainWindow::_UpdateHeight()
 {
-	if (fAppList->LockWithTimeout(50 * 1000) != B_OK)
+	fSelectionMenu->SetEnabled(!fListView->IsEmpty());
+
+	// The window only shows up to kMAX_DISPLAYED_ITEMS rows, it only needs
+	// resizing when that number changed
+	int32 count = fListView->CountItems();
+	count = (count < kMAX_DISPLAYED_ITEMS) ? count : kMAX_DISPLAYED_ITEMS;
+	if (count == fShownRowCount)
 		return;
 
-	const AppListItems* appList = fAppList->Items();
-	if (appList == NULL) {
-		fAppList->Unlock();
+	fShownRowCount = count;
+	BRect itemRect = fListView->ItemFrame(0);
+	float itemHeight = itemRect.Height();
+	float windowRest = Frame().Height() - fListView->Frame().Height();
+	ResizeTo(Bounds().Width(), count * itemHeight + windowRest + count - 2);
+}
+
+
+void
+MainWindow::_SetLoading(bool loading)
+{
+	// While more results are coming, the title says so
+	if (loading == fLoading)
 		return;
+
+	fLoading = loading;
+	if (loading) {
+		BString title(B_TRANSLATE_COMMENT("%appname% (loading more results" B_UTF8_ELLIPSIS ")",
+			"Window title. Don't translate the variable %appname%."));
+		title.ReplaceFirst("%appname%", B_TRANSLATE_SYSTEM_NAME(kApplicationName));
+		SetTitle(title);
+	} else
+		SetTitle(B_TRANSLATE_SYSTEM_NAME(kApplicationName));
+}
+
+
+MainListItem*
+MainWindow::_TakeRow(const SearchResult& result)
+{
+	TRACE_SPAN("MainWindow::_TakeRow");
+	MainListItem* item = fRowPool.Take(result.Ref());
+	if (item != NULL) {
+		// A rebuilt app list has new entries for the same refs, with maybe
+		// another localized name or version
+		if (result.entry.Get() != NULL && item->Entry() != result.entry.Get())
+			item->SetEntry(result.entry.Get());
+		if (item->IsFavorite() != result.isFavorite)
+			item->SetFavorite(result.isFavorite);
+		return item;
 	}
 
-	QLSettings& settings = my_app->Settings();
-	BString searchtext = GetSearchString();
+	if (result.entry.Get() != NULL)
+		return new MainListItem(result.entry.Get(), fIconHeight, result.isFavorite);
 
-	if (settings.Lock()) {
-		int32 searchFromStart = settings.GetTempSearchStart();
-		bool showAll = (searchtext == "*");
-		bool startJocker = searchtext.StartsWith("*");
-		if (startJocker)
-			searchtext.RemoveFirst("*");
-		for (int32 i = 0; i < appList->CountItems(); i++) {
-			BString name = appList->ItemAt(i)->GetName();
-			bool found = true;
-			if (!showAll) {
-				if (searchFromStart == 1 && !startJocker)
-					found = name.IStartsWith(searchtext);
-				else
-					found = name.IFindFirst(searchtext) == B_ERROR ? false : true;
-			}
+	// Favorites come without an entry, the row gets one of its own
+	BEntry entry(&result.ref);
+	if (entry.InitCheck() != B_OK)
+		return NULL;
+
+	bool localized = BLocaleRoster::Default()->IsFilesystemTranslationPreferred();
+	BReference<AppListItem> favorite(new AppListItem(entry, localized), true);
+	return new MainListItem(favorite.Get(), fIconHeight, result.isFavorite);
+}
+
+
+BWindow*
+MainWindow::_SetupWindow()
+{
+	// Only created when it's first needed, it isn't part of starting up
+	if (fSetupWindow == NULL) {
+		fSetupWindow = new SetupWindow(my_app->Settings().GetSetupWindowFrame(), this);
+		fSetupWindow->Hide();
+		fSetupWindow->Show();
+	}
+	return fSetupWindow;
+}
+
+
+void
+MainWindow::_Close()
+{
+	// In resident mode the window only hides, with the app list kept
+	// warm for the next time it's shown
+	if (my_app->Settings().GetResident())
+		_HideToBackground();
+	else
+		be_app->PostMessage(B_QUIT_REQUESTED);
+}
 
-			if (found) {
-				bool isFav = false;
-				BEntry entry = appList->ItemAt(i)->GetRef();
-				for (int32 i = 0; i < settings.fFavoriteList->CountItems(); i++) {
-					entry_ref* favorite
-						= static_cast<entry_ref*>(settings.fFavoriteList->ItemAt(i));
-
-					if (!favorite)
-						continue;
-					BEntry favEntry(favorite);
-					if (favEntry == entry)
-						isFav = true;
-				}
-				if (entry.InitCheck() == B_OK)
-					fListView->AddItem(new MainListItem(&entry, name, fIconHeight, isFav));
-			}
-		}
 
-		if (settings.GetSortFavorites())
-			fListView->SortItems(&compare_favorite_items);
-		else
-			fListView->SortItems(&compare_items);
+void
+MainWindow::_HideToBackground()
+{
+	if (!IsHidden())
+		Hide();
+
+	QLSettings& settings = my_app->Settings();
+	if (settings.Lock()) {
+		settings.SetSearchTerm(GetSearchString());
+		settings.SaveSettings();
+		settings.Unlock();
+	}
+
+	// Like after a restart, the search term is only kept when asked for
+	if (!settings.GetSaveSearch())
+		fSearchBox->SetText("");
+
+	// Rendered rows and icons are dropped while hidden. The app list and the
+	// (slim) rows stay, also the pooled ones with the favorites, which would
+	// otherwise need their entries loaded again. Icons are loaded again when
+	// the rows are drawn.
+	fListView->RowCache().MakeEmpty();
+	for (int32 i = 0; i < fListView->CountItems(); i++) {
+		MainListItem* item = dynamic_cast<MainListItem*>(fListView->ItemAt(i));
+		if (item != NULL)
+			item->Entry()->UnloadIcon();
 	}
-	settings.Unlock();
-	fAppList->Unlock();
+	fAppList->UnloadIcons();
 }
 
 
@@ -669,22 +934,18 @@ MainWindow::_AddDroppedAsFav(BMessage* message)
 
 
 void
-MainWindow::_ShowFavorites()
+MainWindow::_GetFavorites(SearchResults& results)
 {
+	// Only the refs, the favorites are usually all in the row pool already
 	QLSettings& settings = my_app->Settings();
-	bool localized = BLocaleRoster::Default()->IsFilesystemTranslationPreferred();
-
 	for (int32 i = 0; i < settings.fFavoriteList->CountItems(); i++) {
 		entry_ref* favorite = settings.fFavoriteList->ItemAt(i);
 		if (favorite == NULL)
 			continue;
-		BEntry entry(favorite);
-		if (entry.InitCheck() == B_OK) {
-			BString appName;
-			if (!localized
-				|| BLocaleRoster::Default()->GetLocalizedFileName(appName, *favorite) != B_OK)
-				appName = favorite->name;
-			fListView->AddItem(new MainListItem(&entry, appName, fIconHeight, true));
-		}
+
+		SearchResult result;
+		result.ref = *favorite;
+		result.isFavorite = true;
+		results.items.push_back(result);
 	}
 }
@@ -11,6 +11,8 @@
 
 #include "MainListItem.h"
 #include "MainListView.h"
+#include "RowPool.h"
+#include "SearchWorker.h"
 
 #include <Alert.h>
 #include <Application.h>
@@ -21,6 +23,7 @@
 #include <GroupLayoutBuilder.h>
 #include <ListView.h>
 #include <Message.h>
+#include <MessageRunner.h>
 #include <Roster.h>
 #include <Screen.h>
 #include <ScrollView.h>
@@ -30,17 +33,23 @@
 #include <stdlib.h>
 #include <strings.h>
 
+#include <vector>
+
 
 #define SINGLE_CLICK		'1clk'
 #define SETUP_MENU			'setb'
 #define HELP_MENU			'help'
 #define ADDIGNORE			'addi'
+#define UPDATE_UI			'upui'
+#define SHOW_WINDOW			'shwn'
 
 
 #define kMAX_DISPLAYED_ITEMS	10
+#define kMAX_POOLED_ROWS		256
 
 
 class AppList;
+class SearchWorker;
 
 
 class MainWindow : public BWindow {
@@ -54,17 +63,41 @@ public:
 
 	bool			IsFavoritesOnly() { return fSearchBox->TextView()->TextLength() == 0; };
 	const char*		GetSearchString() { return fSearchBox->TextView()->Text(); };
+	void			Navigate(uint32 command, int32 count);
 	void			ResultsCountChanged();
 
 private:
 	void			_RebuildResults();
-	void			_FilterAppList();
-	void			_ShowFavorites();
-
+	void			_UpdateResults(const SearchResults& results);
+	void			_ShowResults(SearchResults* results);
+	void			_QueueAppended(SearchResults* results);
+	void			_AppendQueued();
+	void			_DropAppended();
+	void			_ScheduleUpdate(uint32 updates);
+	void			_ApplyUpdates();
+	void			_UpdateHeight();
+	void			_SetLoading(bool loading);
+	void			_GetFavorites(SearchResults& results);
+
+	MainListItem*	_TakeRow(const SearchResult& result);
+
+	BWindow*		_SetupWindow();
+	void			_Close();
+	void			_HideToBackground();
 	void			_LaunchApp(MainListItem* item);
 	void			_AddDroppedAsFav(BMessage* message);
 
 	AppList*		fAppList;
+	SearchWorker*	fSearchWorker;
+	int32			fSearchGeneration;
+	bool			fLoading;
+	// Chunks to append, the first one partly shown with fAppendedRows
+	std::vector<SearchResults*> fAppendQueue;
+	size_t			fAppendedRows;
+	uint32			fPendingUpdates;
+	int32			fShownRowCount;
+	RowPool			fRowPool;
+	BList			fNewRows; // only kept to spare allocations
 	int32			fIconHeight;
 
 	BMenu*			fSelectionMenu;
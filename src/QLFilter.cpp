@@ -9,6 +9,8 @@
 #include "QLFilter.h"
 #include "QuickLaunch.h"
 
+#include <MessageQueue.h>
+
 
 QLFilter::QLFilter()
 	:
@@ -53,76 +55,85 @@ QLFilter::Filter(BMessage* message, BHandler** target)
 			return B_SKIP_MESSAGE;
 		}
 		case B_UP_ARROW:
-		{
-			BLooper* loop = (*target)->Looper();
-			if (loop) {
-				BMessenger msgr(loop);
-				msgr.SendMessage(CURSOR_UP);
-				return B_SKIP_MESSAGE;
-			}
-		}
+			return _Navigate(message, CURSOR_UP);
 		case B_DOWN_ARROW:
-		{
-			BLooper* loop = (*target)->Looper();
-			if (loop) {
-				BMessenger msgr(loop);
-				msgr.SendMessage(CURSOR_DOWN);
-				return B_SKIP_MESSAGE;
-			}
-		}
+			return _Navigate(message, CURSOR_DOWN);
 		case B_PAGE_UP:
-		{
-			BLooper* loop = (*target)->Looper();
-			if (loop) {
-				BMessenger msgr(loop);
-				msgr.SendMessage(PAGE_UP);
-				return B_SKIP_MESSAGE;
-			}
-		}
+			return _Navigate(message, PAGE_UP);
 		case B_PAGE_DOWN:
-		{
-			BLooper* loop = (*target)->Looper();
-			if (loop) {
-				BMessenger msgr(loop);
-				msgr.SendMessage(PAGE_DOWN);
-				return B_SKIP_MESSAGE;
-			}
-		}
+			return _Navigate(message, PAGE_DOWN);
 		case B_HOME:
-		{
-			BLooper* loop = (*target)->Looper();
-			if (loop) {
-				BMessenger msgr(loop);
-				msgr.SendMessage(HOME);
-				return B_SKIP_MESSAGE;
-			}
-		}
+			return _Navigate(message, HOME);
 		case B_END:
-		{
-			BLooper* loop = (*target)->Looper();
-			if (loop) {
-				BMessenger msgr(loop);
-				msgr.SendMessage(END);
-				return B_SKIP_MESSAGE;
-			}
-		}
+			return _Navigate(message, END);
 		case B_RETURN:
 		{
-			int message;
 			if (mod & B_SHIFT_KEY)
-				message = RETURN_SHIFT_KEY;
+				return _Post(RETURN_SHIFT_KEY);
 			else if (mod & B_CONTROL_KEY)
-				message = RETURN_CTRL_KEY;
-			else
-				message = RETURN_KEY;
-
-			BLooper* loop = (*target)->Looper();
-			if (loop) {
-				BMessenger msgr(loop);
-				msgr.SendMessage(message);
-				return B_SKIP_MESSAGE;
-			}
+				return _Post(RETURN_CTRL_KEY);
+
+			return _Post(RETURN_KEY);
 		}
 	}
 	return B_DISPATCH_MESSAGE;
 }
+
+
+#pragma mark-- Private Methods --
+
+
+filter_result
+QLFilter::_Navigate(BMessage* message, uint32 command)
+{
+	// The filter runs in the window's thread, so it can move the selection
+	// right away instead of posting another message for it
+	MainWindow* window = dynamic_cast<MainWindow*>(Looper());
+	if (window == NULL)
+		return _Post(command);
+
+	window->Navigate(command, 1 + _RemoveQueuedRepeats(message));
+	return B_SKIP_MESSAGE;
+}
+
+
+int32
+QLFilter::_RemoveQueuedRepeats(BMessage* message)
+{
+	// When moving through the list can't keep up with the key repeat, the
+	// repeats pile up in the queue. Those that directly follow are taken
+	// along and counted, so they become a single move.
+	BMessageQueue* queue = Looper()->MessageQueue();
+	if (queue == NULL || !queue->Lock())
+		return 0;
+
+	int32 key = message->GetInt32("key", 0);
+	int32 modifiers = message->GetInt32("modifiers", 0);
+
+	int32 removed = 0;
+	BMessage* next;
+	while ((next = queue->FindMessage(B_KEY_DOWN, 0)) != NULL) {
+		if (next->GetInt32("key", -1) != key
+			|| next->GetInt32("modifiers", -1) != modifiers)
+			break;
+
+		queue->RemoveMessage(next);
+		delete next;
+		removed++;
+	}
+	queue->Unlock();
+
+	return removed;
+}
+
+
+filter_result
+QLFilter::_Post(uint32 command)
+{
+	BLooper* looper = Looper();
+	if (looper == NULL)
+		return B_DISPATCH_MESSAGE;
+
+	looper->PostMessage(command);
+	return B_SKIP_MESSAGE;
+}
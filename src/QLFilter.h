@@ -35,6 +35,11 @@ public:
 							QLFilter();
 	virtual					~QLFilter();
 	virtual filter_result 	Filter(BMessage* message, BHandler** target);
+
+private:
+	filter_result			_Navigate(BMessage* message, uint32 command);
+	int32					_RemoveQueuedRepeats(BMessage* message);
+	filter_result			_Post(uint32 command);
 };
 
 #endif // QL_FILTER_H
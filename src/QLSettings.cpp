@@ -11,6 +11,7 @@
 #include "QLSettings.h"
 #include "IgnoreListItem.h"
 #include "QuickLaunch.h"
+#include "Trace.h"
 
 #include <Application.h>
 #include <File.h>
@@ -20,6 +21,7 @@
 #include <Screen.h>
 
 #include <stdio.h>
+#include <sys/stat.h>
 
 
 const char*
@@ -37,11 +39,11 @@ QLSettings::kDefaultSystemIgnore[] = {
 
 
 QLSettings::QLSettings()
+	:
+	fIgnoreList(NULL),
+	fIgnoreRulesValid(false)
 {
-	BPath path;
-	if (find_directory(B_USER_SETTINGS_DIRECTORY, &path) != B_OK)
-		return;
-
+	TRACE_SPAN("QLSettings::QLSettings");
 	// Defaults
 	BScreen* screen = new BScreen(B_MAIN_SCREEN_ID);
 	BRect resolution = screen->Frame();
@@ -57,10 +59,17 @@ QLSettings::QLSettings()
 	fSearchStart = fTempSearchStart = true;
 	fSaveSearch = false;
 	fSortFavorites = false;
+	fResident = false;
+	fShortcutsChecked = false;
 	fSearchTerm = "";
 	fShowIgnore = fTempApplyIgnore = true;
 	fFavoriteList = new BObjectList<entry_ref>(20, true);
-	fIgnoreList = new IgnoreListView();
+
+	// The settings file is only read here, everything else works with what
+	// is read now
+	BPath path;
+	if (find_directory(B_USER_SETTINGS_DIRECTORY, &path) != B_OK)
+		return;
 
 	path.Append("QuickLaunch_settings");
 	BFile file(path.Path(), B_READ_ONLY);
@@ -107,7 +116,34 @@ QLSettings::QLSettings()
 		int32 sortfavs;
 		if (settings.FindInt32("sort favorites", &sortfavs) == B_OK)
 			fSortFavorites = sortfavs;
-	}
+
+		int32 resident;
+		if (settings.FindInt32("resident", &resident) == B_OK)
+			fResident = resident;
+
+		bool checked;
+		if (settings.FindBool("shortcuts checked", &checked) == B_OK)
+			fShortcutsChecked = checked;
+
+		BString itemText;
+		int32 i = 0;
+		while (settings.FindString("item", i++, &itemText) == B_OK)
+			fIgnoreItems.Add(itemText);
+
+		i = 0;
+		while (settings.FindString("pattern", i++, &itemText) == B_OK)
+			fIgnorePatterns.Add(itemText);
+
+		i = 0;
+		while (settings.FindString("favorite", i++, &itemText) == B_OK) {
+			entry_ref favorite;
+			get_ref_for_path(itemText.String(), &favorite);
+			BEntry entry(&favorite);
+			if (entry.Exists())
+				fFavoriteList->AddItem(new entry_ref(favorite));
+		}
+	} else // First launch? Add default ignore items
+		AddDefaultIgnore();
 }
 
 
@@ -135,14 +171,23 @@ QLSettings::SaveSettings()
 	settings.AddString("searchterm", fSearchTerm);
 	settings.AddInt32("show ignore", fShowIgnore);
 	settings.AddInt32("sort favorites", fSortFavorites);
+	settings.AddInt32("resident", fResident);
+	settings.AddBool("shortcuts checked", fShortcutsChecked);
 
-	for (int32 i = 0; i < fIgnoreList->CountItems(); i++) {
-		IgnoreListItem* item = dynamic_cast<IgnoreListItem*>(fIgnoreList->ItemAt(i));
-		if (!item)
-			continue;
+	if (fIgnoreList != NULL) {
+		for (int32 i = 0; i < fIgnoreList->CountItems(); i++) {
+			IgnoreListItem* item = dynamic_cast<IgnoreListItem*>(fIgnoreList->ItemAt(i));
+			if (!item)
+				continue;
 
-		if (item->GetItem())
-			settings.AddString("item", item->GetItem());
+			if (item->GetItem())
+				settings.AddString(item->IsPattern() ? "pattern" : "item", item->GetItem());
+		}
+	} else {
+		for (int32 i = 0; i < fIgnoreItems.CountStrings(); i++)
+			settings.AddString("item", fIgnoreItems.StringAt(i));
+		for (int32 i = 0; i < fIgnorePatterns.CountStrings(); i++)
+			settings.AddString("pattern", fIgnorePatterns.StringAt(i));
 	}
 
 	for (int32 i = 0; i < fFavoriteList->CountItems(); i++) {
@@ -166,32 +211,58 @@ QLSettings::SaveSettings()
 }
 
 
+IgnoreListView*
+QLSettings::IgnoreList()
+{
+	// The list view, with a check of every item whether it's a folder, is
+	// only needed for the settings window, not for starting up
+	if (fIgnoreList == NULL) {
+		fIgnoreList = new IgnoreListView();
+		for (int32 i = 0; i < fIgnoreItems.CountStrings(); i++)
+			fIgnoreList->AddItem(new IgnoreListItem(fIgnoreItems.StringAt(i)));
+		for (int32 i = 0; i < fIgnorePatterns.CountStrings(); i++)
+			fIgnoreList->AddItem(new IgnoreListItem(fIgnorePatterns.StringAt(i), true));
+	}
+	return fIgnoreList;
+}
+
+
+IgnoreRules&
+QLSettings::GetIgnoreRules()
+{
+	// Compiled on first use, which is in the app list builder's thread
+	if (Lock()) {
+		if (!fIgnoreRulesValid)
+			_CompileIgnoreRules();
+		Unlock();
+	}
+	return fIgnoreRules;
+}
+
+
 void
-QLSettings::InitLists()
+QLSettings::UpdateIgnoreRules()
 {
-	BPath path;
-	if (find_directory(B_USER_SETTINGS_DIRECTORY, &path) != B_OK)
+	// Takes over the changed ignore list, the rules the app list builder
+	// checks against are compiled anew when next used. Call it from the
+	// settings window after every change to the list.
+	if (!Lock())
 		return;
-	path.Append("QuickLaunch_settings");
-	BFile file(path.Path(), B_READ_ONLY);
 
-	BMessage settings;
-	if (file.InitCheck() == B_OK && settings.Unflatten(&file) == B_OK) {
-		BString itemText;
-		int32 i = 0;
-		while (settings.FindString("item", i++, &itemText) == B_OK) {
-			fIgnoreList->AddItem(new IgnoreListItem(itemText.String()));
-		}
-		i = 0;
-		while (settings.FindString("favorite", i++, &itemText) == B_OK) {
-			entry_ref favorite;
-			get_ref_for_path(itemText.String(), &favorite);
-			BEntry entry(&favorite);
-			if (entry.Exists())
-				fFavoriteList->AddItem(new entry_ref(favorite));
-		}
-	} else // First launch? Add default ignore items
-		AddDefaultIgnore();
+	fIgnoreItems.MakeEmpty();
+	fIgnorePatterns.MakeEmpty();
+	for (int32 i = 0; i < fIgnoreList->CountItems(); i++) {
+		IgnoreListItem* item = dynamic_cast<IgnoreListItem*>(fIgnoreList->ItemAt(i));
+		if (item == NULL)
+			continue;
+		if (item->IsPattern())
+			fIgnorePatterns.Add(item->GetItem());
+		else
+			fIgnoreItems.Add(item->GetItem());
+	}
+	fIgnoreRulesValid = false;
+
+	Unlock();
 }
 
 
@@ -202,22 +273,46 @@ QLSettings::AddDefaultIgnore()
 	if (find_directory(B_SYSTEM_DIRECTORY, &systemDir) != B_OK)
 		return;
 
-	int32 count = fIgnoreList->CountItems();
+	IgnoreListView* ignoreList = IgnoreList();
+	int32 count = ignoreList->CountItems();
 
 	for (const char** list = kDefaultSystemIgnore; *list != NULL; ++list) {
 		bool inList = false;
 		BString dir = systemDir.Path();
 		dir << "/" << *list;
 		for (int i = 0; i < count; i++) {
-			IgnoreListItem* item = dynamic_cast<IgnoreListItem*>(fIgnoreList->ItemAt(i));
+			IgnoreListItem* item = dynamic_cast<IgnoreListItem*>(ignoreList->ItemAt(i));
 			if (strcasecmp(dir.String(), item->GetItem()) == 0) {
 				inList = true;
 				break;
 			}
 		}
 		if (!inList)
-			fIgnoreList->AddItem(new IgnoreListItem(dir));
+			ignoreList->AddItem(new IgnoreListItem(dir));
 	}
+	UpdateIgnoreRules();
+}
+
+
+#pragma mark-- Private Methods --
+
+
+void
+QLSettings::_CompileIgnoreRules()
+{
+	std::lock_guard<std::mutex> lock(fIgnoreRules.Mutex());
+
+	fIgnoreRules.MakeEmpty();
+	for (int32 i = 0; i < fIgnoreItems.CountStrings(); i++) {
+		const BString& item = fIgnoreItems.StringAt(i);
+		struct stat st;
+		bool isDirectory = stat(item.String(), &st) == 0 && S_ISDIR(st.st_mode);
+		fIgnoreRules.AddRule(item, isDirectory);
+	}
+	for (int32 i = 0; i < fIgnorePatterns.CountStrings(); i++)
+		fIgnoreRules.AddPattern(fIgnorePatterns.StringAt(i));
+
+	fIgnoreRulesValid = true;
 }
 
 
@@ -12,12 +12,14 @@
 #define QLSETTINGS_H
 
 #include "IgnoreListView.h"
+#include "IgnoreRules.h"
 
 #include <Entry.h>
 #include <Locker.h>
 #include <ObjectList.h>
 #include <Rect.h>
 #include <String.h>
+#include <StringList.h>
 
 
 class QLSettings {
@@ -40,6 +42,8 @@ public:
 	void	SetSearchTerm(BString searchterm) { fSearchTerm = searchterm; };
 	void	SetApplyIgnore(int32 ignore) { fShowIgnore = ignore; };
 	void	SetSortFavorites(int32 sortfavs) { fSortFavorites = sortfavs; };
+	void	SetResident(int32 resident) { fResident = resident; };
+	void	SetShortcutsChecked(bool checked) { fShortcutsChecked = checked; };
 
 	BRect	GetMainWindowFrame() { return fMainWindowFrame; };
 	BRect	GetSetupWindowFrame() { return fSetupWindowFrame; };
@@ -51,6 +55,8 @@ public:
 	BString	GetSearchTerm() { return fSearchTerm; };
 	int32	GetApplyIgnore() { return fShowIgnore; };
 	int32	GetSortFavorites() { return fSortFavorites; };
+	int32	GetResident() { return fResident; };
+	bool	GetShortcutsChecked() { return fShortcutsChecked; };
 
 	// Set/Getters for "Temporary options" menu
 	void	SetTempShowVersion(int32 version) { fTempShowVersion = version; };
@@ -62,14 +68,16 @@ public:
 	int32	GetTempSearchStart() { return fTempSearchStart; };
 	int32	GetTempApplyIgnore() { return fTempApplyIgnore; };
 
-	void			InitLists();
-	IgnoreListView* IgnoreList() { return fIgnoreList; };
+	IgnoreListView* IgnoreList();
+	IgnoreRules&	GetIgnoreRules();
+	void			UpdateIgnoreRules();
 	void			AddDefaultIgnore();
 
 	BObjectList<entry_ref>* fFavoriteList;
-	IgnoreListView*	fIgnoreList;
 
 private:
+	void	_CompileIgnoreRules();
+
 	BRect	fMainWindowFrame;
 	BRect	fSetupWindowFrame;
 	int32	fDeskbar;
@@ -80,6 +88,8 @@ private:
 	BString	fSearchTerm;
 	int32	fShowIgnore;
 	int32	fSortFavorites;
+	int32	fResident;
+	bool	fShortcutsChecked;
 
 	// Settings for "Temporary options" menu
 	int32	fTempShowVersion;
@@ -88,6 +98,14 @@ private:
 	int32	fTempApplyIgnore;
 	static const char* kDefaultSystemIgnore[];
 
+	// The ignore list as saved, until the IgnoreListView is needed for the
+	// settings window, and as of the last UpdateIgnoreRules() after that.
+	// Only what was added as a pattern is one, the items are plain paths.
+	BStringList		fIgnoreItems;
+	BStringList		fIgnorePatterns;
+	IgnoreListView*	fIgnoreList;
+	IgnoreRules		fIgnoreRules;
+	bool			fIgnoreRulesValid;
 	BLocker	fLock;
 
 };
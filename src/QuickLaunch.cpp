@@ -12,10 +12,12 @@
 
 #include "QuickLaunch.h"
 #include "QLFilter.h"
+#include "Trace.h"
 
 #include <AboutWindow.h>
 #include <Catalog.h>
 #include <Deskbar.h>
+#include <LocaleRoster.h>
 #include <PathFinder.h>
 
 const char* kApplicationSignature = "application/x-vnd.humdinger-quicklaunch";
@@ -31,15 +33,14 @@ QLApp::QLApp()
 	BApplication(kApplicationSignature),
 	fMainWindow(NULL)
 {
-	// Check if user's Shortcuts have the old QL location
+	TRACE_SPAN("QLApp::QLApp");
+	// Check once if user's Shortcuts have the old QL location
 	// ToDo: Remove some time after R1beta5
-	if (_OpenShortcutPrefs())
-		return;
-
-	if (fSettings.GetDeskbar()) // make sure the replicant is shown
-		_AddToDeskbar();
-
-	fSettings.InitLists();
+	if (!fSettings.GetShortcutsChecked()) {
+		fSettings.SetShortcutsChecked(true);
+		if (_OpenShortcutPrefs())
+			return;
+	}
 
 	fMainWindow = new MainWindow();
 }
@@ -88,6 +89,28 @@ QLApp::MessageReceived(BMessage* message)
 			_OpenHelp();
 			break;
 		}
+		case B_SILENT_RELAUNCH:
+		{
+			// Started again, e.g. from the Deskbar, while running in the
+			// background
+			if (fMainWindow != NULL)
+				fMainWindow->PostMessage(SHOW_WINDOW);
+			break;
+		}
+		case B_LOCALE_CHANGED:
+		{
+			// Names and sort order of the app list depend on the locale
+			BLocaleRoster::Default()->Refresh();
+			if (fMainWindow != NULL)
+				fMainWindow->PostMessage(message);
+			break;
+		}
+		case ADD_TO_DESKBAR:
+		{
+			// make sure the replicant is shown
+			_AddToDeskbar();
+			break;
+		}
 		case DESKBAR_CHK:
 		{
 			int32 value;
@@ -123,11 +146,19 @@ QLApp::QuitRequested()
 void
 QLApp::ReadyToRun()
 {
+	TRACE_SPAN("QLApp::ReadyToRun");
+	if (fMainWindow == NULL)
+		return;
+
 	BRect frame = fSettings.GetMainWindowFrame();
 
 	fMainWindow->MoveTo(frame.LeftTop());
 	fMainWindow->ResizeBy(frame.Width() - fMainWindow->Frame().Width(), 0);
 	fMainWindow->Show();
+
+	// Talking to the Deskbar can wait until the window is up
+	if (fSettings.GetDeskbar())
+		PostMessage(ADD_TO_DESKBAR);
 }
 
 
@@ -250,9 +281,14 @@ QLApp::_OpenShortcutPrefs()
 
 
 int
-main()
+main(int argc, char** argv)
 {
-	QLApp app;
-	app.Run();
+	Trace::Init(argc, argv);
+	{
+		QLApp app;
+		app.Run();
+	}
+	// Written after the app is gone, so no other thread still records
+	Trace::Write();
 	return 0;
 }
@@ -18,6 +18,8 @@
 
 #define my_app dynamic_cast<QLApp*>(be_app)
 
+#define ADD_TO_DESKBAR	'adtd'
+
 
 class QLApp : public BApplication {
 public:
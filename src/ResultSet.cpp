@@ -0,0 +1,192 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "ResultSet.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+
+#if defined(__GNUC__)
+// Two words at a time, the compiler maps this to SSE2/NEON where available
+typedef uint64_t word_vector __attribute__((vector_size(16)));
+static const size_t kWordsPerVector = sizeof(word_vector) / sizeof(uint64_t);
+#define VECTOR_LOOP(words, other, count, op) \
+	{ \
+		size_t i = 0; \
+		for (; i + kWordsPerVector <= count; i += kWordsPerVector) { \
+			word_vector a, b; \
+			memcpy(&a, &(words)[i], sizeof(a)); \
+			memcpy(&b, &(other)[i], sizeof(b)); \
+			a = op; \
+			memcpy(&(words)[i], &a, sizeof(a)); \
+		} \
+		for (; i < count; i++) { \
+			uint64_t a = (words)[i]; \
+			uint64_t b = (other)[i]; \
+			(words)[i] = op; \
+		} \
+	}
+#else
+#define VECTOR_LOOP(words, other, count, op) \
+	{ \
+		for (size_t i = 0; i < (count); i++) { \
+			uint64_t a = (words)[i]; \
+			uint64_t b = (other)[i]; \
+			(words)[i] = op; \
+		} \
+	}
+#endif
+
+
+static inline int32_t
+count_bits(uint64_t word)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(word);
+#else
+	int32_t count = 0;
+	for (; word != 0; word &= word - 1)
+		count++;
+	return count;
+#endif
+}
+
+
+static inline int32_t
+lowest_bit(uint64_t word)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(word);
+#else
+	int32_t bit = 0;
+	while ((word & 1) == 0) {
+		word >>= 1;
+		bit++;
+	}
+	return bit;
+#endif
+}
+
+
+ResultSet::ResultSet()
+	:
+	fCount(0)
+{
+}
+
+
+ResultSet::ResultSet(int32_t count)
+	:
+	fCount(0)
+{
+	SetCount(count);
+}
+
+
+void
+ResultSet::SetCount(int32_t count)
+{
+	fCount = count;
+	fWords.assign((count + 63) / 64, 0);
+}
+
+
+void
+ResultSet::SetAll()
+{
+	if (fWords.empty())
+		return;
+
+	memset(&fWords[0], 0xff, fWords.size() * sizeof(uint64_t));
+	_ClearPastEnd();
+}
+
+
+void
+ResultSet::ClearAll()
+{
+	if (!fWords.empty())
+		memset(&fWords[0], 0, fWords.size() * sizeof(uint64_t));
+}
+
+
+ResultSet&
+ResultSet::And(const ResultSet& other)
+{
+	size_t count = std::min(fWords.size(), other.fWords.size());
+	VECTOR_LOOP(fWords, other.fWords, count, a & b)
+	if (count < fWords.size())
+		memset(&fWords[count], 0, (fWords.size() - count) * sizeof(uint64_t));
+	return *this;
+}
+
+
+ResultSet&
+ResultSet::Or(const ResultSet& other)
+{
+	size_t count = std::min(fWords.size(), other.fWords.size());
+	VECTOR_LOOP(fWords, other.fWords, count, a | b)
+	if (other.fCount > fCount)
+		_ClearPastEnd();
+	return *this;
+}
+
+
+ResultSet&
+ResultSet::AndNot(const ResultSet& other)
+{
+	size_t count = std::min(fWords.size(), other.fWords.size());
+	VECTOR_LOOP(fWords, other.fWords, count, a & ~b)
+	return *this;
+}
+
+
+int32_t
+ResultSet::CountSet() const
+{
+	int32_t count = 0;
+	for (size_t i = 0; i < fWords.size(); i++)
+		count += count_bits(fWords[i]);
+
+	return count;
+}
+
+
+int32_t
+ResultSet::NextSet(int32_t from) const
+{
+	if (from < 0)
+		from = 0;
+	if (from >= fCount)
+		return -1;
+
+	size_t index = from >> 6;
+	uint64_t word = fWords[index] & (~uint64_t(0) << (from & 63));
+	while (word == 0) {
+		if (++index == fWords.size())
+			return -1;
+		word = fWords[index];
+	}
+
+	return int32_t(index << 6) + lowest_bit(word);
+}
+
+
+#pragma mark-- Private Methods --
+
+
+void
+ResultSet::_ClearPastEnd()
+{
+	// Bits past the end always stay cleared, so CountSet() and NextSet()
+	// don't have to care about them
+	if ((fCount & 63) != 0 && !fWords.empty())
+		fWords.back() &= (uint64_t(1) << (fCount & 63)) - 1;
+}
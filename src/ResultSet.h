@@ -0,0 +1,55 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+#ifndef RESULTSET_H
+#define RESULTSET_H
+
+
+#include <stdint.h>
+#include <vector>
+
+
+// A packed set of app list indices. Every search condition (name match,
+// favorite, ignored, ...) is one ResultSet over the same app list, and the
+// conditions are combined a whole word (or vector) at a time. Sets of
+// different counts can be combined too, indices past the other set's count
+// are taken as not set.
+
+class ResultSet {
+public:
+							ResultSet();
+							ResultSet(int32_t count);
+
+	void					SetCount(int32_t count);
+	int32_t					Count() const { return fCount; };
+
+	void					Set(int32_t index)
+								{ fWords[index >> 6] |= uint64_t(1) << (index & 63); };
+	void					Clear(int32_t index)
+								{ fWords[index >> 6] &= ~(uint64_t(1) << (index & 63)); };
+	bool					Test(int32_t index) const
+								{ return (fWords[index >> 6] >> (index & 63)) & 1; };
+
+	void					SetAll();
+	void					ClearAll();
+
+	ResultSet&				And(const ResultSet& other);
+	ResultSet&				Or(const ResultSet& other);
+	ResultSet&				AndNot(const ResultSet& other);
+
+	int32_t					CountSet() const;
+	int32_t					NextSet(int32_t from) const;
+
+private:
+	void					_ClearPastEnd();
+
+	std::vector<uint64_t>	fWords;
+	int32_t					fCount;
+};
+
+
+#endif // RESULTSET_H
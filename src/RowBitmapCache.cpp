@@ -0,0 +1,132 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "RowBitmapCache.h"
+
+#include "MainListItem.h"
+#include "QuickLaunch.h"
+
+
+RowBitmapCache::RowBitmapCache(int32 maxSize)
+	:
+	fMaxSize(maxSize)
+{
+}
+
+
+RowBitmapCache::~RowBitmapCache()
+{
+	MakeEmpty();
+}
+
+
+void
+RowBitmapCache::Draw(BView* view, MainListItem* item, BRect rect)
+{
+	QLSettings& settings = my_app->Settings();
+
+	Key key;
+	key.entry = item->Entry();
+	key.selected = item->IsSelected();
+
+	State state;
+	state.width = rect.Width();
+	state.height = rect.Height();
+	state.favorite = item->IsFavorite();
+	state.showVersion = settings.GetTempShowVersion();
+	state.showPath = settings.GetTempShowPath();
+
+	Row* row = _RowFor(key);
+	if (row->bitmap == NULL || !(row->state == state)) {
+		row->state = state;
+		if (!_Render(row, item, rect)) {
+			// No bitmap to be had, draw directly
+			item->DrawRow(view, rect);
+			return;
+		}
+	}
+
+	view->DrawBitmap(row->bitmap, rect.LeftTop());
+}
+
+
+void
+RowBitmapCache::MakeEmpty()
+{
+	for (RowList::iterator it = fRows.begin(); it != fRows.end(); it++) {
+		delete (*it)->bitmap;
+		delete *it;
+	}
+
+	fRows.clear();
+	fRowMap.clear();
+}
+
+
+#pragma mark-- Private Methods --
+
+
+RowBitmapCache::Row*
+RowBitmapCache::_RowFor(const Key& key)
+{
+	RowMap::iterator found = fRowMap.find(key);
+	if (found != fRowMap.end()) {
+		// move to the front
+		fRows.splice(fRows.begin(), fRows, found->second);
+		return *found->second;
+	}
+
+	Row* row = new Row;
+	row->entry.SetTo(key.entry);
+	row->key = key;
+	row->bitmap = NULL;
+
+	fRows.push_front(row);
+	fRowMap[key] = fRows.begin();
+	_Trim();
+
+	return row;
+}
+
+
+bool
+RowBitmapCache::_Render(Row* row, MainListItem* item, BRect rect)
+{
+	BRect bounds(0, 0, rect.Width(), rect.Height());
+	if (row->bitmap == NULL || row->bitmap->Bounds() != bounds) {
+		delete row->bitmap;
+		row->bitmap = new BBitmap(bounds, B_RGB32, true);
+		if (!row->bitmap->IsValid()) {
+			delete row->bitmap;
+			row->bitmap = NULL;
+			return false;
+		}
+		row->bitmap->AddChild(new BView(bounds, "row", B_FOLLOW_NONE, B_WILL_DRAW));
+	}
+
+	BView* view = row->bitmap->ChildAt(0);
+	row->bitmap->Lock();
+	item->DrawRow(view, bounds);
+	view->Sync();
+	row->bitmap->Unlock();
+
+	return true;
+}
+
+
+void
+RowBitmapCache::_Trim()
+{
+	while (int32(fRows.size()) > fMaxSize) {
+		Row* row = fRows.back();
+		fRowMap.erase(row->key);
+		fRows.pop_back();
+		delete row->bitmap;
+		delete row;
+	}
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+#ifndef ROWBITMAPCACHE_H
+#define ROWBITMAPCACHE_H
+
+
+#include "AppListItem.h"
+
+#include <Bitmap.h>
+#include <Referenceable.h>
+#include <View.h>
+
+#include <list>
+#include <unordered_map>
+
+
+class MainListItem;
+
+
+// Keeps rendered result rows, so moving the selection or scrolling only
+// blits bitmaps instead of drawing icons and text again. A row is cached per
+// entry and selection state and drawn anew when anything else it depends on
+// changed. The least recently drawn rows are dropped when there are more
+// than maxSize. Colors and fonts aren't part of the state, the cache has to
+// be emptied when they change.
+
+class RowBitmapCache {
+public:
+							RowBitmapCache(int32 maxSize);
+							~RowBitmapCache();
+
+	void					Draw(BView* view, MainListItem* item, BRect rect);
+	void					MakeEmpty();
+
+private:
+	struct Key {
+		AppListItem*		entry;
+		bool				selected;
+
+		bool				operator==(const Key& other) const
+								{ return entry == other.entry
+									&& selected == other.selected; };
+	};
+
+	struct KeyHash {
+		size_t				operator()(const Key& key) const
+								{ return size_t(key.entry) * 2 + key.selected; };
+	};
+
+	// Everything else the rendered row depends on
+	struct State {
+		float				width;
+		float				height;
+		bool				favorite;
+		bool				showVersion;
+		bool				showPath;
+
+		bool				operator==(const State& other) const
+								{ return width == other.width
+									&& height == other.height
+									&& favorite == other.favorite
+									&& showVersion == other.showVersion
+									&& showPath == other.showPath; };
+	};
+
+	struct Row {
+		BReference<AppListItem>	entry; // keeps the key valid
+		Key					key;
+		State				state;
+		BBitmap*			bitmap;
+	};
+
+	typedef std::list<Row*> RowList;
+	typedef std::unordered_map<Key, RowList::iterator, KeyHash> RowMap;
+
+	Row*					_RowFor(const Key& key);
+	bool					_Render(Row* row, MainListItem* item, BRect rect);
+	void					_Trim();
+
+	RowList					fRows; // most recently drawn first
+	RowMap					fRowMap;
+	int32					fMaxSize;
+};
+
+
+#endif // ROWBITMAPCACHE_H
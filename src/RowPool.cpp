@@ -0,0 +1,135 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "RowPool.h"
+
+
+RowPool::RowPool(int32 maxSize)
+	:
+	fNewest(NULL),
+	fOldest(NULL),
+	fCount(0),
+	fMaxSize(maxSize)
+{
+	// A power of two, with room for the favorites beyond maxSize
+	size_t bucketCount = 16;
+	while (bucketCount < size_t(maxSize) * 2)
+		bucketCount *= 2;
+	fBuckets.assign(bucketCount, NULL);
+}
+
+
+RowPool::~RowPool()
+{
+	MakeEmpty();
+}
+
+
+MainListItem*
+RowPool::Take(const entry_ref& ref)
+{
+	for (MainListItem* item = *_Bucket(ref); item != NULL; item = item->fPoolNextInBucket) {
+		if (*item->Ref() == ref) {
+			_Remove(item);
+			return item;
+		}
+	}
+	return NULL;
+}
+
+
+void
+RowPool::Put(MainListItem* item)
+{
+	if (item == NULL)
+		return;
+
+	MainListItem* existing = Take(*item->Ref());
+	if (existing != item)
+		delete existing;
+
+	MainListItem** bucket = _Bucket(*item->Ref());
+	item->fPoolNextInBucket = *bucket;
+	*bucket = item;
+
+	item->fPoolNewer = NULL;
+	item->fPoolOlder = fNewest;
+	if (fNewest != NULL)
+		fNewest->fPoolNewer = item;
+	fNewest = item;
+	if (fOldest == NULL)
+		fOldest = item;
+
+	fCount++;
+}
+
+
+void
+RowPool::Trim()
+{
+	MainListItem* item = fOldest;
+	while (fCount > fMaxSize && item != NULL) {
+		MainListItem* newer = item->fPoolNewer;
+		if (!item->IsFavorite()) {
+			_Remove(item);
+			delete item;
+		}
+		item = newer;
+	}
+}
+
+
+void
+RowPool::MakeEmpty()
+{
+	MainListItem* item = fNewest;
+	while (item != NULL) {
+		MainListItem* older = item->fPoolOlder;
+		delete item;
+		item = older;
+	}
+
+	fBuckets.assign(fBuckets.size(), NULL);
+	fNewest = NULL;
+	fOldest = NULL;
+	fCount = 0;
+}
+
+
+#pragma mark-- Private Methods --
+
+
+MainListItem**
+RowPool::_Bucket(const entry_ref& ref)
+{
+	return &fBuckets[EntryRefHash()(ref) & (fBuckets.size() - 1)];
+}
+
+
+void
+RowPool::_Remove(MainListItem* item)
+{
+	MainListItem** link = _Bucket(*item->Ref());
+	while (*link != item)
+		link = &(*link)->fPoolNextInBucket;
+	*link = item->fPoolNextInBucket;
+
+	if (item->fPoolNewer != NULL)
+		item->fPoolNewer->fPoolOlder = item->fPoolOlder;
+	else
+		fNewest = item->fPoolOlder;
+	if (item->fPoolOlder != NULL)
+		item->fPoolOlder->fPoolNewer = item->fPoolNewer;
+	else
+		fOldest = item->fPoolNewer;
+
+	item->fPoolNewer = NULL;
+	item->fPoolOlder = NULL;
+	item->fPoolNextInBucket = NULL;
+	fCount--;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+#ifndef ROWPOOL_H
+#define ROWPOOL_H
+
+
+#include "MainListItem.h"
+
+#include <vector>
+
+
+// Keeps rows that are currently not shown, so they can be reused when their
+// entry shows up again instead of loading icon, version etc. once more.
+// Trim() deletes the least recently put back rows when there are more than
+// maxSize, except favorites, which always stay around. The pool owns all
+// rows put into it, so they must not be shown anymore.
+// The rows are linked through their own pool links, a hash table of those
+// for lookups and a list from most to least recently put back, so taking
+// and putting back rows doesn't allocate.
+
+class RowPool {
+public:
+							RowPool(int32 maxSize);
+							~RowPool();
+
+	MainListItem*			Take(const entry_ref& ref);
+	void					Put(MainListItem* item);
+	void					Trim();
+	void					MakeEmpty();
+
+private:
+	MainListItem**			_Bucket(const entry_ref& ref);
+	void					_Remove(MainListItem* item);
+
+	std::vector<MainListItem*> fBuckets;
+	MainListItem*			fNewest;
+	MainListItem*			fOldest;
+	int32					fCount;
+	int32					fMaxSize;
+};
+
+
+#endif // ROWPOOL_H
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "SearchEngine.h"
+
+#include <string.h>
+
+
+// How many entries are checked between asking the canceller
+static const int32_t kCancelCheckInterval = 1024;
+
+
+static inline char
+ascii_lower(char c)
+{
+	return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
+
+
+// Like strncasecmp() in the C locale, which BString::IStartsWith() and
+// BString::IFindFirst() use. The text is already lowercase.
+static inline bool
+starts_with_ignoring_case(const char* name, const char* text, size_t length)
+{
+	for (size_t i = 0; i < length; i++) {
+		if (name[i] == '\0' || ascii_lower(name[i]) != text[i])
+			return false;
+	}
+	return true;
+}
+
+
+SearchQuery::SearchQuery()
+	:
+	fFromStart(true),
+	fMatchesAll(false)
+{
+}
+
+
+SearchQuery::SearchQuery(const char* text, bool searchFromStart)
+{
+	SetTo(text, searchFromStart);
+}
+
+
+void
+SearchQuery::SetTo(const char* text, bool searchFromStart)
+{
+	fMatchesAll = strcmp(text, "*") == 0;
+	fFromStart = searchFromStart;
+	if (text[0] == '*') {
+		fFromStart = false;
+		text++;
+	}
+
+	fText.assign(text);
+	for (size_t i = 0; i < fText.size(); i++)
+		fText[i] = ascii_lower(fText[i]);
+}
+
+
+bool
+SearchQuery::Matches(const char* name) const
+{
+	if (fMatchesAll)
+		return true;
+
+	const char* text = fText.c_str();
+	size_t length = fText.size();
+	if (fFromStart)
+		return starts_with_ignoring_case(name, text, length);
+
+	if (length == 0)
+		return true;
+
+	// Only positions starting with the first letter are compared in full
+	char first = text[0];
+	for (; *name != '\0'; name++) {
+		if (ascii_lower(*name) == first
+			&& starts_with_ignoring_case(name + 1, text + 1, length - 1))
+			return true;
+	}
+	return false;
+}
+
+
+#pragma mark-- SearchEngine --
+
+
+SearchEngine::SearchEngine()
+{
+}
+
+
+/*static*/ int
+SearchEngine::CompareEntries(const char* sortKeyA, const char* sortPathA,
+	const char* sortKeyB, const char* sortPathB)
+{
+	// Sort keys are compared byte by byte, as unsigned chars
+	int cmp = strcmp(sortKeyA, sortKeyB);
+	if (cmp != 0)
+		return cmp;
+
+	return strcmp(sortPathA, sortPathB);
+}
+
+
+void
+SearchEngine::ApplyIgnoreRules(const EntryProvider& entries, const IgnoreRules& rules)
+{
+	int32_t count = entries.CountEntries();
+	fIgnored.SetCount(count);
+
+	if (rules.IsEmpty())
+		return;
+
+	for (int32_t i = 0; i < count; i++) {
+		if (rules.Ignores(entries.PathAt(i)))
+			fIgnored.Set(i);
+	}
+}
+
+
+bool
+SearchEngine::Search(const EntryProvider& entries, const SearchQuery& query,
+	bool applyIgnore, bool favoritesFirst, std::vector<SearchMatch>& matches,
+	const SearchCanceller* canceller)
+{
+	matches.clear();
+
+	// Every condition is a set over the entries, they are combined
+	// word-wise and only the resulting set is walked entry by entry
+	int32_t count = entries.CountEntries();
+	fResults.SetCount(count);
+	if (query.MatchesAll())
+		fResults.SetAll();
+	else {
+		for (int32_t i = 0; i < count; i++) {
+			if ((i % kCancelCheckInterval) == 0 && canceller != NULL
+				&& canceller->IsCancelled())
+				return false;
+
+			if (query.Matches(entries.NameAt(i)))
+				fResults.Set(i);
+		}
+	}
+
+	if (applyIgnore)
+		fResults.AndNot(fIgnored);
+
+	fFavorites.SetCount(count);
+	for (int32_t i = fResults.NextSet(0); i >= 0; i = fResults.NextSet(i + 1)) {
+		if (entries.IsFavorite(i))
+			fFavorites.Set(i);
+	}
+
+	// The entries are in display order, so the results are as well. With
+	// favorites first, that's just the favorite results followed by the rest.
+	matches.reserve(fResults.CountSet());
+	if (favoritesFirst) {
+		_AddMatches(fFavorites, true, matches);
+		fResults.AndNot(fFavorites);
+		_AddMatches(fResults, false, matches);
+	} else {
+		for (int32_t i = fResults.NextSet(0); i >= 0; i = fResults.NextSet(i + 1)) {
+			SearchMatch match = { i, fFavorites.Test(i) };
+			matches.push_back(match);
+		}
+	}
+
+	return true;
+}
+
+
+#pragma mark-- Private Methods --
+
+
+void
+SearchEngine::_AddMatches(const ResultSet& results, bool isFavorite,
+	std::vector<SearchMatch>& matches) const
+{
+	for (int32_t i = results.NextSet(0); i >= 0; i = results.NextSet(i + 1)) {
+		SearchMatch match = { i, isFavorite };
+		matches.push_back(match);
+	}
+}
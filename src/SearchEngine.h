@@ -0,0 +1,111 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+#ifndef SEARCHENGINE_H
+#define SEARCHENGINE_H
+
+
+#include "IgnoreRules.h"
+#include "ResultSet.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+// Matching, ignoring and ordering of search results in plain C++, without
+// Kit types. Together with ResultSet and IgnoreRules it builds and runs on
+// any system, so it can be checked and profiled outside of Haiku, see
+// tests/Makefile. The app hands it the app list through an EntryProvider.
+
+
+// The entries to search, in display order, see SearchEngine::CompareEntries()
+class EntryProvider {
+public:
+	virtual					~EntryProvider() {};
+
+	virtual int32_t			CountEntries() const = 0;
+	// The (localized) name matched by searches, UTF-8
+	virtual const char*		NameAt(int32_t index) const = 0;
+	// The full path checked against the ignore rules
+	virtual const char*		PathAt(int32_t index) const = 0;
+	// Only asked for entries that matched
+	virtual bool			IsFavorite(int32_t index) const = 0;
+};
+
+
+// Asked every now and then during a search, whether it is still wanted
+class SearchCanceller {
+public:
+	virtual					~SearchCanceller() {};
+
+	virtual bool			IsCancelled() const = 0;
+};
+
+
+// What was typed: "*" shows everything, a leading "*" searches for the rest
+// anywhere in names, even when searching from the start. Case is ignored
+// for ASCII letters.
+class SearchQuery {
+public:
+							SearchQuery();
+							SearchQuery(const char* text, bool searchFromStart);
+
+	void					SetTo(const char* text, bool searchFromStart);
+
+	bool					MatchesAll() const { return fMatchesAll; };
+	bool					Matches(const char* name) const;
+
+private:
+	std::string				fText;
+	bool					fFromStart;
+	bool					fMatchesAll;
+};
+
+
+struct SearchMatch {
+	int32_t					index;
+	bool					isFavorite;
+};
+
+
+class SearchEngine {
+public:
+							SearchEngine();
+
+	// The display order, which the entries have to be in: by the collation
+	// sort key of their names, then by their lowercase paths
+	static	int				CompareEntries(const char* sortKeyA, const char* sortPathA,
+								const char* sortKeyB, const char* sortPathB);
+
+	// Evaluates the rules for all entries, to be called whenever either
+	// changes
+	void					ApplyIgnoreRules(const EntryProvider& entries,
+								const IgnoreRules& rules);
+	const ResultSet&		Ignored() const { return fIgnored; };
+
+	// Fills matches in display order, with favorites first if asked for.
+	// Returns false if the search was cancelled.
+	bool					Search(const EntryProvider& entries, const SearchQuery& query,
+								bool applyIgnore, bool favoritesFirst,
+								std::vector<SearchMatch>& matches,
+								const SearchCanceller* canceller = NULL);
+
+private:
+	void					_AddMatches(const ResultSet& results, bool isFavorite,
+								std::vector<SearchMatch>& matches) const;
+
+private:
+	ResultSet				fIgnored;
+
+	// scratch space for Search(), kept to spare allocations
+	ResultSet				fResults;
+	ResultSet				fFavorites;
+};
+
+
+#endif // SEARCHENGINE_H
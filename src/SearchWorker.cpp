@@ -0,0 +1,287 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "SearchWorker.h"
+
+#include "QuickLaunch.h"
+#include "Trace.h"
+
+#include <algorithm>
+
+
+// Results after the first chunk are sent in chunks of this size
+static const int32 kResultChunkSize = 256;
+
+// At most this many result chunks are kept for reuse, and only if they
+// aren't too large
+static const int32 kMaxRecycledResults = 64;
+static const size_t kMaxRecycledCapacity = 4096;
+
+
+// Cancels a search as soon as a newer one was asked for
+class GenerationCanceller : public SearchCanceller {
+public:
+	GenerationCanceller(int32* current, int32 generation)
+		:
+		fCurrent(current),
+		fGeneration(generation)
+	{
+	}
+
+	bool IsCancelled() const
+	{
+		return atomic_get(fCurrent) != fGeneration;
+	}
+
+private:
+	int32* fCurrent;
+	int32 fGeneration;
+};
+
+
+SearchWorker::SearchWorker(AppList* appList, BMessenger target)
+	:
+	BLooper("result searcher"),
+	fAppList(appList),
+	fTarget(target),
+	fGeneration(0),
+	fPendingLock("pending search"),
+	fPendingGeneration(0),
+	fPendingFromStart(true),
+	fPendingApplyIgnore(true),
+	fPendingFavoritesFirst(false),
+	fPendingChunkSize(0),
+	fPendingQueued(false),
+	fRecycledLock("recycled results")
+{
+	fRecycled.reserve(kMaxRecycledResults);
+	Run();
+}
+
+
+SearchWorker::~SearchWorker()
+{
+	for (size_t i = 0; i < fRecycled.size(); i++)
+		delete fRecycled[i];
+}
+
+
+void
+SearchWorker::MessageReceived(BMessage* message)
+{
+	switch (message->what) {
+		case SEARCH:
+		{
+			_Search();
+			break;
+		}
+		default:
+		{
+			BLooper::MessageReceived(message);
+			break;
+		}
+	}
+}
+
+
+int32
+SearchWorker::Search(const char* searchText, bool searchFromStart, bool applyIgnore,
+	bool favoritesFirst, int32 firstChunkSize)
+{
+	// Every search gets a new generation, results of older ones are dropped
+	// here or by the window, whoever notices first
+	int32 generation = atomic_add(&fGeneration, 1) + 1;
+
+	// Only one search is ever queued, newer ones replace what it searches for
+	fPendingLock.Lock();
+	fPendingGeneration = generation;
+	fPendingText.assign(searchText);
+	fPendingFromStart = searchFromStart;
+	fPendingApplyIgnore = applyIgnore;
+	fPendingFavoritesFirst = favoritesFirst;
+	fPendingChunkSize = firstChunkSize;
+	bool queued = fPendingQueued;
+	fPendingQueued = true;
+	fPendingLock.Unlock();
+
+	if (!queued)
+		PostMessage(SEARCH);
+
+	return generation;
+}
+
+
+int32
+SearchWorker::Cancel()
+{
+	return atomic_add(&fGeneration, 1) + 1;
+}
+
+
+SearchResults*
+SearchWorker::NewResults()
+{
+	SearchResults* results = NULL;
+	fRecycledLock.Lock();
+	if (!fRecycled.empty()) {
+		results = fRecycled.back();
+		fRecycled.pop_back();
+	}
+	fRecycledLock.Unlock();
+
+	return results != NULL ? results : new SearchResults;
+}
+
+
+void
+SearchWorker::Recycle(SearchResults* results)
+{
+	if (results == NULL)
+		return;
+
+	// Releases the entries, but keeps the storage for the next search
+	results->items.clear();
+	if (results->items.capacity() <= kMaxRecycledCapacity) {
+		fRecycledLock.Lock();
+		if (int32(fRecycled.size()) < kMaxRecycledResults) {
+			fRecycled.push_back(results);
+			results = NULL;
+		}
+		fRecycledLock.Unlock();
+	}
+
+	delete results;
+}
+
+
+#pragma mark-- Private Methods --
+
+
+void
+SearchWorker::_Search()
+{
+	TRACE_SPAN("SearchWorker::_Search");
+	fPendingLock.Lock();
+	int32 generation = fPendingGeneration;
+	fText.assign(fPendingText);
+	bool searchFromStart = fPendingFromStart;
+	bool applyIgnore = fPendingApplyIgnore;
+	bool favoritesFirst = fPendingFavoritesFirst;
+	int32 firstChunkSize = fPendingChunkSize;
+	fPendingQueued = false;
+	fPendingLock.Unlock();
+
+	if (_IsSuperseded(generation))
+		return;
+
+	_UpdateFavorites();
+
+	if (fAppList->Lock() == false)
+		return;
+
+	const AppListItems* appList = fAppList->Items();
+	if (appList == NULL || _IsSuperseded(generation)) {
+		fAppList->Unlock();
+		return;
+	}
+
+	AppListEntries entries(appList, &fFavorites);
+	fQuery.SetTo(fText.c_str(), searchFromStart);
+	GenerationCanceller canceller(&fGeneration, generation);
+	if (!fAppList->Engine().Search(entries, fQuery, applyIgnore, favoritesFirst, fMatches,
+			&canceller)) {
+		fAppList->Unlock();
+		return;
+	}
+
+	// The entries are referenced while the list is locked, the chunks are
+	// sent after. There's always a first chunk, even without results.
+	fChunks.clear();
+	size_t matchCount = fMatches.size();
+	size_t chunkSize = firstChunkSize > 0 ? firstChunkSize : kResultChunkSize;
+	size_t start = 0;
+	do {
+		size_t end = std::min(start + chunkSize, matchCount);
+		SearchResults* chunk = NewResults();
+		chunk->items.resize(end - start);
+		for (size_t i = start; i < end; i++) {
+			SearchResult& result = chunk->items[i - start];
+			result.entry.SetTo(appList->ItemAt(fMatches[i].index));
+			result.isFavorite = fMatches[i].isFavorite;
+		}
+		fChunks.push_back(chunk);
+
+		start = end;
+		chunkSize = kResultChunkSize;
+	} while (start < matchCount);
+	fAppList->Unlock();
+
+	_SendResults(generation);
+}
+
+
+void
+SearchWorker::_UpdateFavorites()
+{
+	// Favorites are copied, so the settings aren't locked during the search.
+	// They rarely change, and are only copied again when they did.
+	QLSettings& settings = my_app->Settings();
+	if (!settings.Lock())
+		return;
+
+	BObjectList<entry_ref>* favorites = settings.fFavoriteList;
+	bool changed = favorites->CountItems() != int32(fFavorites.size());
+	for (int32 i = 0; i < favorites->CountItems() && !changed; i++) {
+		entry_ref* favorite = favorites->ItemAt(i);
+		changed = favorite == NULL || *favorite != fFavorites[i];
+	}
+
+	if (changed) {
+		fFavorites.clear();
+		for (int32 i = 0; i < favorites->CountItems(); i++) {
+			entry_ref* favorite = favorites->ItemAt(i);
+			if (favorite != NULL)
+				fFavorites.push_back(*favorite);
+		}
+	}
+	settings.Unlock();
+}
+
+
+void
+SearchWorker::_SendResults(int32 generation)
+{
+	TRACE_SPAN("SearchWorker::_SendResults");
+	// The first page can be shown while the rest is still on its way, each
+	// chunk is a message of its own, "last" marks the end
+	size_t sent = 0;
+	for (; sent < fChunks.size(); sent++) {
+		if (_IsSuperseded(generation))
+			break;
+
+		BMessage reply(SEARCH_RESULTS);
+		reply.AddInt32("generation", generation);
+		reply.AddPointer("results", fChunks[sent]);
+		reply.AddBool("first", sent == 0);
+		reply.AddBool("last", sent + 1 == fChunks.size());
+		if (fTarget.SendMessage(&reply) != B_OK)
+			break;
+	}
+
+	// What wasn't sent is kept for the next search
+	for (; sent < fChunks.size(); sent++)
+		Recycle(fChunks[sent]);
+	fChunks.clear();
+}
+
+
+bool
+SearchWorker::_IsSuperseded(int32 generation)
+{
+	return atomic_get(&fGeneration) != generation;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+#ifndef SEARCHWORKER_H
+#define SEARCHWORKER_H
+
+
+#include "AppList.h"
+
+#include <Entry.h>
+#include <Locker.h>
+#include <Looper.h>
+#include <Messenger.h>
+#include <ObjectList.h>
+#include <Referenceable.h>
+#include <String.h>
+
+#include <string>
+#include <vector>
+
+
+#define SEARCH			'srch'
+#define SEARCH_RESULTS	'srsl'
+
+
+// The entry is referenced, not copied. Favorites shown without a search
+// have no entry from the app list, only their ref.
+struct SearchResult {
+	entry_ref				ref;
+	BReference<AppListItem>	entry;
+	bool					isFavorite;
+
+	const entry_ref&		Ref() const
+								{ return entry.Get() != NULL ? *entry.Get()->GetRef() : ref; };
+};
+
+
+// Results come in display order, since they are collected from the
+// presorted app list. They are sent in chunks, the first one as large as
+// the window's first page. Chunks are handed back to the SearchWorker with
+// Recycle(), so their storage can be reused by later searches.
+struct SearchResults {
+	std::vector<SearchResult>	items;
+};
+
+
+class SearchWorker : public BLooper {
+public:
+							SearchWorker(AppList* appList, BMessenger target);
+	virtual					~SearchWorker();
+
+	void					MessageReceived(BMessage* message);
+
+	int32					Search(const char* searchText, bool searchFromStart,
+								bool applyIgnore, bool favoritesFirst,
+								int32 firstChunkSize);
+	int32					Cancel();
+
+	SearchResults*			NewResults();
+	void					Recycle(SearchResults* results);
+
+private:
+	void					_Search();
+	void					_UpdateFavorites();
+	void					_SendResults(int32 generation);
+	bool					_IsSuperseded(int32 generation);
+
+	AppList*				fAppList;
+	BMessenger				fTarget;
+	int32					fGeneration;
+
+	// The latest search asked for. Searches asked for while one is still
+	// queued only replace it.
+	BLocker					fPendingLock;
+	int32					fPendingGeneration;
+	std::string				fPendingText;
+	bool					fPendingFromStart;
+	bool					fPendingApplyIgnore;
+	bool					fPendingFavoritesFirst;
+	int32					fPendingChunkSize;
+	bool					fPendingQueued;
+
+	// only used by _Search(), kept to spare allocations
+	std::string				fText;
+	SearchQuery				fQuery;
+	std::vector<SearchMatch> fMatches;
+	std::vector<entry_ref>	fFavorites;
+	std::vector<SearchResults*> fChunks;
+
+	BLocker					fRecycledLock;
+	std::vector<SearchResults*> fRecycled;
+};
+
+
+#endif // SEARCHWORKER_H
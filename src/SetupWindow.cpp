@@ -48,6 +48,13 @@ SetupWindow::SetupWindow(BRect frame, BMessenger main_msgr)
 		new BMessage(DESKBAR_CHK), B_WILL_DRAW | B_NAVIGABLE);
 	fChkDeskbar->SetExplicitMaxSize(BSize(B_SIZE_UNLIMITED, B_SIZE_UNSET));
 
+	fChkResident = new BCheckBox("ResidentChk", B_TRANSLATE("Keep running in the background"),
+		new BMessage(RESIDENT_CHK), B_WILL_DRAW | B_NAVIGABLE);
+	fChkResident->SetExplicitMaxSize(BSize(B_SIZE_UNLIMITED, B_SIZE_UNSET));
+	fChkResident->SetToolTip(B_TRANSLATE(
+		"Hide the window instead of quitting after launching an app.\n"
+		"Starting QuickLaunch again shows it right away."));
+
 	fChkVersion = new BCheckBox("VersionChk", B_TRANSLATE("Show application version"),
 		new BMessage(VERSION_CHK), B_WILL_DRAW | B_NAVIGABLE);
 	fChkVersion->SetExplicitMaxSize(BSize(B_SIZE_UNLIMITED, B_SIZE_UNSET));
@@ -84,6 +91,15 @@ SetupWindow::SetupWindow(BRect frame, BMessenger main_msgr)
 	fIgnoreScroll->SetExplicitMinSize(BSize(B_SIZE_UNSET, 48));
 	fIgnoreScroll->SetExplicitMaxSize(BSize(B_SIZE_UNLIMITED, B_SIZE_UNSET));
 
+	fPatternControl = new BTextControl("PatternControl", B_TRANSLATE("Pattern:"), "",
+		new BMessage(ADD_PATTERN));
+	fPatternControl->SetToolTip(B_TRANSLATE(
+		"Ignore all files and folders matching a pattern, e.g. '*_x86' or '*/bin/*-test'.\n"
+		"'*' and '?' match within a folder name, '**' matches any number of folders."));
+
+	fButAddPattern = new BButton("AddPatternButton", B_TRANSLATE("Add pattern"),
+		new BMessage(ADD_PATTERN));
+
 	BButton* butDefaults = new BButton("DefaultsButton", B_TRANSLATE("Defaults"),
 		new BMessage(DEFAULTS_BUT));
 
@@ -106,6 +122,7 @@ SetupWindow::SetupWindow(BRect frame, BMessenger main_msgr)
 			.SetInsets(B_USE_WINDOW_INSETS)
 		.AddGroup(B_VERTICAL, 0)
 			.Add(fChkDeskbar)
+			.Add(fChkResident)
 			.End()
 		.AddGroup(B_VERTICAL, 0)
 			.Add(fChkVersion)
@@ -126,6 +143,10 @@ SetupWindow::SetupWindow(BRect frame, BMessenger main_msgr)
 			.Add(fChkIgnore)
 			.Add(fIgnoreScroll)
 			.End()
+		.AddGroup(B_HORIZONTAL, B_USE_DEFAULT_SPACING)
+			.Add(fPatternControl)
+			.Add(fButAddPattern)
+			.End()
 		.AddGroup(B_HORIZONTAL, B_USE_DEFAULT_SPACING)
 			.Add(butDefaults)
 			.AddGlue()
@@ -136,6 +157,7 @@ SetupWindow::SetupWindow(BRect frame, BMessenger main_msgr)
 
 	if (settings.Lock()) {
 		fChkDeskbar->SetValue(settings.GetDeskbar());
+		fChkResident->SetValue(settings.GetResident());
 		fChkVersion->SetValue(settings.GetShowVersion());
 		fChkPath->SetValue(settings.GetShowPath());
 		fChkSearchStart->SetValue(settings.GetSearchStart());
@@ -187,7 +209,7 @@ SetupWindow::MessageReceived(BMessage* message)
 	switch (message->what) {
 		case IGNORE_CHK:
 		{
-			if (settings.fIgnoreList->IsEmpty()) {
+			if (fIgnoreList->IsEmpty()) {
 				fChkIgnore->SetValue(false);
 				settings.SetApplyIgnore(false);
 
@@ -209,16 +231,23 @@ SetupWindow::MessageReceived(BMessage* message)
 			settings.SetSaveSearch(value);
 			break;
 		}
+		case RESIDENT_CHK:
+		{
+			int32 value;
+			message->FindInt32("be:value", &value);
+			settings.SetResident(value);
+			break;
+		}
 		case FILEPANEL:
 		{
-			if (!settings.fIgnoreList->IsEmpty()) {
+			if (!fIgnoreList->IsEmpty()) {
 				fChkIgnore->SetValue(true);
 				settings.SetApplyIgnore(true);
 			} else {
 				fChkIgnore->SetValue(false);
 				settings.SetApplyIgnore(false);
 			}
-			fMainMessenger.SendMessage(new BMessage(BUILDAPPLIST));
+			_IgnoreListChanged();
 			break;
 		}
 		case OPEN_SHORTCUTS:
@@ -231,6 +260,7 @@ SetupWindow::MessageReceived(BMessage* message)
 			QLSettings& settings = my_app->Settings();
 			settings.AddDefaultIgnore();
 			fIgnoreList->SortItems(&compare_items);
+			_IgnoreListChanged();
 			break;
 		}
 		case ADD_BUT:
@@ -238,10 +268,33 @@ SetupWindow::MessageReceived(BMessage* message)
 			fOpenPanel->Show();
 			break;
 		}
+		case ADD_PATTERN:
+		{
+			BString pattern(fPatternControl->Text());
+			pattern.Trim();
+			if (pattern.IsEmpty())
+				break;
+
+			bool duplicate = false;
+			for (int i = 0; i < fIgnoreList->CountItems(); i++) {
+				IgnoreListItem* sItem = dynamic_cast<IgnoreListItem*>(fIgnoreList->ItemAt(i));
+				if (sItem->IsPattern() && pattern == sItem->GetItem()) {
+					duplicate = true;
+					break;
+				}
+			}
+			if (!duplicate) {
+				fIgnoreList->AddItem(new IgnoreListItem(pattern, true));
+				fIgnoreList->SortItems(&compare_items);
+				_IgnoreListChanged();
+			}
+			fPatternControl->SetText("");
+			break;
+		}
 		case REM_BUT:
 		{
 			_RemoveSelected();
-			fMainMessenger.SendMessage(new BMessage(BUILDAPPLIST));
+			_IgnoreListChanged();
 			break;
 		}
 		case B_SIMPLE_DATA:
@@ -263,7 +316,8 @@ SetupWindow::MessageReceived(BMessage* message)
 					for (int i = 0; i < fIgnoreList->CountItems(); i++) {
 						IgnoreListItem* sItem
 							= dynamic_cast<IgnoreListItem*>(fIgnoreList->ItemAt(i));
-						if (strcmp(sItem->GetItem(), newitem->GetItem()) == 0) {
+						if (!sItem->IsPattern()
+							&& strcmp(sItem->GetItem(), newitem->GetItem()) == 0) {
 							duplicate = true;
 							break;
 						}
@@ -279,7 +333,7 @@ SetupWindow::MessageReceived(BMessage* message)
 				}
 				settings.Unlock();
 			}
-			fMainMessenger.SendMessage(new BMessage(BUILDAPPLIST));
+			_IgnoreListChanged();
 		}
 	}
 }
@@ -288,6 +342,14 @@ SetupWindow::MessageReceived(BMessage* message)
 #pragma mark-- Private Methods --
 
 
+void
+SetupWindow::_IgnoreListChanged()
+{
+	my_app->Settings().UpdateIgnoreRules();
+	fMainMessenger.SendMessage(IGNORELIST_CHANGED);
+}
+
+
 void
 SetupWindow::_GetSelectedItems(BList& indices)
 {
@@ -27,6 +27,7 @@
 #include <Path.h>
 #include <Screen.h>
 #include <ScrollView.h>
+#include <TextControl.h>
 #include <Window.h>
 
 #include <stdio.h>
@@ -37,14 +38,17 @@
 #define SEARCHSTART_CHK	'chst'
 #define SAVESEARCH_CHK	'chss'
 #define SORTFAVS_CHK	'chsf'
+#define RESIDENT_CHK	'chrs'
 #define IGNORE_CHK		'chig'
 #define OPEN_SHORTCUTS	'opsc'
 #define ADD_BUT			'addb'
+#define ADD_PATTERN		'addp'
 #define REM_BUT			'remb'
 #define DEFAULTS_BUT	'defl'
 #define FILEPANEL		'file'
 #define POPCLOSE		'clpo'
 #define BUILDAPPLIST	'buil'
+#define IGNORELIST_CHANGED	'igch'
 
 class SetupWindow : public BWindow {
 public:
@@ -55,6 +59,7 @@ public:
 	void			MessageReceived(BMessage* message);
 
 	BCheckBox*		fChkDeskbar;
+	BCheckBox*		fChkResident;
 	BCheckBox*		fChkVersion;
 	BCheckBox*		fChkPath;
 	BCheckBox*		fChkSearchStart;
@@ -65,12 +70,15 @@ public:
 
 private:
 
+			void	_IgnoreListChanged();
 			void	_GetSelectedItems(BList& indices);
 			void	_RemoveSelected(); // uses RemoveItemList()
 	virtual	void	_RemoveItemList(const BList& indices);
 
 	BScrollView*	fIgnoreScroll;
 	BButton*		fButAdd;
+	BTextControl*	fPatternControl;
+	BButton*		fButAddPattern;
 	BFilePanel*		fOpenPanel;
 
 	IgnoreListView*	fIgnoreList;
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "Trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <String.h>
+
+
+// Events per thread, older ones are overwritten
+static const int32 kBufferSize = 16384;
+static const int32 kMaxThreads = 32;
+
+
+struct TraceEvent {
+	const char*	name;
+	bigtime_t	start;
+	bigtime_t	end;
+};
+
+
+// Only ever written by its own thread, so recording needs no locking.
+// They are read when writing the trace, after the other threads are done.
+struct ThreadBuffer {
+	thread_id	thread;
+	char		name[B_OS_NAME_LENGTH];
+	int64		count;
+	TraceEvent	events[kBufferSize];
+};
+
+
+bool Trace::gEnabled = false;
+
+static char* sPath = NULL;
+static team_id sTeam = -1;
+static ThreadBuffer* sBuffers[kMaxThreads];
+static int32 sBufferCount = 0;
+static thread_local ThreadBuffer* sThreadBuffer = NULL;
+
+
+static ThreadBuffer*
+thread_buffer()
+{
+	if (sThreadBuffer != NULL)
+		return sThreadBuffer;
+
+	int32 index = atomic_add(&sBufferCount, 1);
+	if (index >= kMaxThreads)
+		return NULL;
+
+	ThreadBuffer* buffer = new ThreadBuffer;
+	buffer->thread = find_thread(NULL);
+	buffer->count = 0;
+
+	thread_info info;
+	if (get_thread_info(buffer->thread, &info) == B_OK)
+		strlcpy(buffer->name, info.name, sizeof(buffer->name));
+	else
+		snprintf(buffer->name, sizeof(buffer->name), "%" B_PRId32, buffer->thread);
+
+	sBuffers[index] = buffer;
+	sThreadBuffer = buffer;
+	return buffer;
+}
+
+
+void
+Trace::Init(int argc, char** argv)
+{
+	const char* path = getenv("QUICKLAUNCH_TRACE");
+	for (int i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "--trace=", 8) == 0)
+			path = argv[i] + 8;
+	}
+
+	if (path == NULL || path[0] == '\0')
+		return;
+
+	sPath = strdup(path);
+	thread_info info;
+	if (get_thread_info(find_thread(NULL), &info) == B_OK)
+		sTeam = info.team;
+
+	gEnabled = true;
+}
+
+
+void
+Trace::Record(const char* name, bigtime_t start, bigtime_t end)
+{
+	ThreadBuffer* buffer = thread_buffer();
+	if (buffer == NULL)
+		return;
+
+	TraceEvent& event = buffer->events[buffer->count % kBufferSize];
+	event.name = name;
+	event.start = start;
+	event.end = end;
+	buffer->count++;
+}
+
+
+void
+Trace::Write()
+{
+	if (!gEnabled)
+		return;
+
+	FILE* file = fopen(sPath, "w");
+	if (file == NULL) {
+		fprintf(stderr, "QuickLaunch: could not write trace to %s\n", sPath);
+		return;
+	}
+
+	fprintf(file, "{\"traceEvents\":[\n");
+	bool first = true;
+
+	int32 bufferCount = atomic_get(&sBufferCount);
+	if (bufferCount > kMaxThreads)
+		bufferCount = kMaxThreads;
+
+	for (int32 i = 0; i < bufferCount; i++) {
+		ThreadBuffer* buffer = sBuffers[i];
+		if (buffer == NULL)
+			continue;
+
+		// Names are literals, only the thread names need escaping
+		BString threadName(buffer->name);
+		threadName.CharacterEscape("\"\\", '\\');
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%" B_PRId32
+			",\"tid\":%" B_PRId32 ",\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n",
+			sTeam, buffer->thread, threadName.String());
+		first = false;
+
+		int64 start = buffer->count > kBufferSize ? buffer->count - kBufferSize : 0;
+		for (int64 j = start; j < buffer->count; j++) {
+			const TraceEvent& event = buffer->events[j % kBufferSize];
+			fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%" B_PRId64
+				",\"dur\":%" B_PRId64 ",\"pid\":%" B_PRId32 ",\"tid\":%" B_PRId32 "}",
+				event.name, event.start, event.end - event.start, sTeam, buffer->thread);
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+
+#include <OS.h>
+
+
+// Scoped spans showing where the time goes, e.g. between start and first
+// paint or during a keystroke. They are recorded per thread and written as
+// Chrome trace events (for chrome://tracing or Perfetto) when QuickLaunch
+// quits, if it was started with the QUICKLAUNCH_TRACE environment variable
+// or the --trace=<file> argument naming the file to write.
+// Without either, a span costs a single branch.
+
+namespace Trace {
+
+extern bool gEnabled;
+
+void	Init(int argc, char** argv);
+void	Record(const char* name, bigtime_t start, bigtime_t end);
+void	Write();
+
+}
+
+
+class TraceSpan {
+public:
+	// name has to be a string literal, only the pointer is kept
+	TraceSpan(const char* name)
+		:
+		fName(name),
+		fStart(0)
+	{
+		if (__builtin_expect(Trace::gEnabled, false))
+			fStart = system_time();
+	}
+
+	~TraceSpan()
+	{
+		if (__builtin_expect(Trace::gEnabled, false))
+			Trace::Record(fName, fStart, system_time());
+	}
+
+private:
+	const char*	fName;
+	bigtime_t	fStart;
+};
+
+
+#define TRACE_SPAN(name) TraceSpan traceSpan(name)
+
+
+#endif // TRACE_H
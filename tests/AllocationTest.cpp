@@ -0,0 +1,122 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "SearchEngine.h"
+#include "SyntheticCatalog.h"
+#include "Test.h"
+#include "TestCatalog.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <new>
+
+
+// Once the engine's scratch space has grown, a search must not allocate:
+// every operator new is counted while queries are typed a second time.
+// This only covers what SearchWorker::_Search() has the engine do. The
+// window's side still allocates the BMessages for the search and its
+// result chunks, and rows for results the RowPool doesn't have.
+
+static bool sCounting = false;
+static int32_t sAllocations = 0;
+
+
+static void*
+counted_alloc(size_t size)
+{
+	if (sCounting)
+		sAllocations++;
+
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == NULL)
+		throw std::bad_alloc();
+	return memory;
+}
+
+
+void* operator new(size_t size) { return counted_alloc(size); }
+void* operator new[](size_t size) { return counted_alloc(size); }
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete[](void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+void operator delete[](void* memory, size_t) noexcept { free(memory); }
+
+
+// Typed one letter at a time, with every search setting
+static const char* kQueries[] = { "ma", "pix", "*edit", "*", "", "ка", "zzz" };
+
+
+static void
+type_queries(SearchEngine& engine, SearchQuery& query, const TestCatalog& catalog,
+	std::vector<SearchMatch>& matches)
+{
+	// Like SearchWorker's pending text, it's only copied into a buffer
+	char text[64];
+	for (size_t i = 0; i < sizeof(kQueries) / sizeof(kQueries[0]); i++) {
+		size_t typedLength = strlen(kQueries[i]);
+		for (size_t length = 0; length <= typedLength; length++) {
+			memcpy(text, kQueries[i], length);
+			text[length] = '\0';
+			for (int32_t settings = 0; settings < 8; settings++) {
+				query.SetTo(text, (settings & 1) != 0);
+				engine.Search(catalog, query, (settings & 2) != 0, (settings & 4) != 0,
+					matches);
+			}
+		}
+	}
+}
+
+
+int
+main()
+{
+	TestCatalog catalog;
+	SyntheticCatalog synthetic(20000);
+	std::string name;
+	std::string path;
+	while (synthetic.GetNext(name, path))
+		catalog.Add(name, path, synthetic.Random(100) == 0);
+
+	IgnoreRules rules;
+	rules.AddRule("/boot/system/bin", true);
+	rules.AddRule("/boot/system/add-ons", true);
+	rules.AddPattern("*Tracker*");
+
+	SearchEngine engine;
+	SearchQuery query;
+	std::vector<SearchMatch> matches;
+
+	// Warming up: the scratch space grows to what the queries need
+	engine.ApplyIgnoreRules(catalog, rules);
+	type_queries(engine, query, catalog, matches);
+
+	sCounting = true;
+	type_queries(engine, query, catalog, matches);
+	int32_t searchAllocations = sAllocations;
+	engine.ApplyIgnoreRules(catalog, rules);
+	int32_t ignoreAllocations = sAllocations - searchAllocations;
+	sCounting = false;
+
+	if (searchAllocations != 0)
+		fprintf(stderr, "warm keystrokes allocated %d times\n", int(searchAllocations));
+	if (ignoreAllocations != 0)
+		fprintf(stderr, "warm ignore rules allocated %d times\n", int(ignoreAllocations));
+	CHECK(searchAllocations == 0);
+	CHECK(ignoreAllocations == 0);
+
+	// The counting itself works
+	sCounting = true;
+	int32_t before = sAllocations;
+	std::vector<int32_t>* vector = new std::vector<int32_t>(16);
+	CHECK(sAllocations - before == 2);
+	delete vector;
+	sCounting = false;
+
+	return test_result("AllocationTest");
+}
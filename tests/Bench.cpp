@@ -0,0 +1,192 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "Bench.h"
+
+#include <string.h>
+
+
+// Baselines are measured on one machine and compared on others, so
+// regressions only count when they're well beyond the noise
+static const double kDefaultMaxRatio = 2.0;
+
+
+BenchResults::BenchResults(bool quick)
+	:
+	fQuick(quick)
+{
+}
+
+
+bool
+BenchResults::Write(const char* path) const
+{
+	return _Write(path, 0);
+}
+
+
+bool
+BenchResults::WriteBaseline(const char* path, double maxRatio) const
+{
+	return _Write(path, maxRatio);
+}
+
+
+int32_t
+BenchResults::Compare(const char* baselinePath, FILE* report) const
+{
+	std::vector<Result> baseline;
+	if (!_Read(baselinePath, baseline)) {
+		fprintf(report, "No baseline in %s\n", baselinePath);
+		return -1;
+	}
+
+	int32_t regressions = 0;
+	fprintf(report, "%-32s %12s %12s %8s\n", "benchmark", "us/op", "baseline", "ratio");
+	for (size_t i = 0; i < fResults.size(); i++) {
+		const Result& result = fResults[i];
+		const Result* expected = NULL;
+		for (size_t j = 0; j < baseline.size(); j++) {
+			if (baseline[j].name == result.name) {
+				expected = &baseline[j];
+				break;
+			}
+		}
+
+		if (expected == NULL) {
+			fprintf(report, "%-32s %12.3f %12s %8s  new\n", result.name.c_str(),
+				result.value, "-", "-");
+			continue;
+		}
+
+		double ratio = expected->value > 0 ? result.value / expected->value : 0;
+		bool regressed = ratio > expected->maxRatio;
+		if (regressed)
+			regressions++;
+		fprintf(report, "%-32s %12.3f %12.3f %8.2f%s\n", result.name.c_str(),
+			result.value, expected->value, ratio,
+			regressed ? "  REGRESSION" : "");
+	}
+
+	fprintf(report, "%d regressions\n", int(regressions));
+	return regressions;
+}
+
+
+#pragma mark-- Private Methods --
+
+
+void
+BenchResults::_Add(const std::string& name, double value)
+{
+	Result result = { name, value, kDefaultMaxRatio };
+	fResults.push_back(result);
+	fprintf(stderr, "%s: %.3f us\n", name.c_str(), value);
+}
+
+
+/*static*/ bool
+BenchResults::_Read(const char* path, std::vector<Result>& results)
+{
+	FILE* file = fopen(path, "r");
+	if (file == NULL)
+		return false;
+
+	// Only reads what _Write() writes, one benchmark per line
+	char line[1024];
+	while (fgets(line, sizeof(line), file) != NULL) {
+		char name[256];
+		Result result;
+		result.maxRatio = kDefaultMaxRatio;
+		if (sscanf(line, " { \"name\": \"%255[^\"]\", \"value\": %lf, \"max_ratio\": %lf",
+				name, &result.value, &result.maxRatio) < 2)
+			continue;
+
+		result.name = name;
+		results.push_back(result);
+	}
+
+	fclose(file);
+	return true;
+}
+
+
+bool
+BenchResults::_Write(const char* path, double maxRatio) const
+{
+	FILE* file = fopen(path, "w");
+	if (file == NULL) {
+		fprintf(stderr, "Could not write %s\n", path);
+		return false;
+	}
+
+	fprintf(file, "{\"unit\": \"us/op\", \"benchmarks\": [\n");
+	for (size_t i = 0; i < fResults.size(); i++) {
+		fprintf(file, "  {\"name\": \"%s\", \"value\": %.4f", fResults[i].name.c_str(),
+			fResults[i].value);
+		if (maxRatio > 0)
+			fprintf(file, ", \"max_ratio\": %.2f", maxRatio);
+		fprintf(file, "}%s\n", i + 1 < fResults.size() ? "," : "");
+	}
+	fprintf(file, "]}\n");
+
+	return fclose(file) == 0;
+}
+
+
+#pragma mark-- main --
+
+
+static void
+usage()
+{
+	fprintf(stderr, "Usage: Bench [--quick] [--output=<file>] [--baseline=<file>]\n"
+		"             [--write-baseline=<file>]\n"
+		"  --quick           fewer and shorter runs, to see that it works\n"
+		"  --output          writes the results as JSON\n"
+		"  --baseline        compares the results, fails on regressions\n"
+		"  --write-baseline  writes the results as the new baseline\n");
+}
+
+
+int
+main(int argc, char** argv)
+{
+	bool quick = false;
+	const char* output = NULL;
+	const char* baseline = NULL;
+	const char* newBaseline = NULL;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0)
+			quick = true;
+		else if (strncmp(argv[i], "--output=", 9) == 0)
+			output = argv[i] + 9;
+		else if (strncmp(argv[i], "--baseline=", 11) == 0)
+			baseline = argv[i] + 11;
+		else if (strncmp(argv[i], "--write-baseline=", 17) == 0)
+			newBaseline = argv[i] + 17;
+		else {
+			usage();
+			return 2;
+		}
+	}
+
+	BenchResults results(quick);
+	bench_ignore_rules(results);
+	bench_result_set(results);
+	bench_search(results);
+
+	if (output != NULL && !results.Write(output))
+		return 1;
+	if (newBaseline != NULL && !results.WriteBaseline(newBaseline, kDefaultMaxRatio))
+		return 1;
+	if (baseline != NULL && results.Compare(baseline, stdout) != 0)
+		return 1;
+
+	return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+#ifndef BENCH_H
+#define BENCH_H
+
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+
+// Times the benchmarks and compares them to a baseline. Every result is
+// the fastest of several runs, in microseconds per operation, so lower is
+// better. Results are written as JSON, one benchmark per line, and the
+// baseline is the same with a "max_ratio" each: a result more than that
+// many times its baseline value is a regression.
+
+class BenchResults {
+public:
+							BenchResults(bool quick);
+
+	bool					IsQuick() const { return fQuick; };
+
+	// Runs function until it ran at least a few times and for a while,
+	// records the fastest run divided by operations
+	template<typename Function>
+	void					Measure(const std::string& name, int64_t operations,
+								Function function);
+
+	bool					Write(const char* path) const;
+	bool					WriteBaseline(const char* path, double maxRatio) const;
+	// Returns the number of regressions, or -1 if there is no baseline
+	int32_t					Compare(const char* baselinePath, FILE* report) const;
+
+private:
+	struct Result {
+		std::string			name;
+		double				value;
+		double				maxRatio;
+	};
+
+	void					_Add(const std::string& name, double value);
+	static	bool			_Read(const char* path, std::vector<Result>& results);
+	bool					_Write(const char* path, double maxRatio) const;
+
+	bool					fQuick;
+	std::vector<Result>		fResults;
+};
+
+
+// The benchmarks, by the part of the engine they measure
+void bench_ignore_rules(BenchResults& results);
+void bench_result_set(BenchResults& results);
+void bench_search(BenchResults& results);
+
+
+template<typename Function>
+void
+BenchResults::Measure(const std::string& name, int64_t operations, Function function)
+{
+	typedef std::chrono::steady_clock Clock;
+	const int32_t kMinRuns = 3;
+	const int32_t kMaxRuns = 1000;
+	const std::chrono::milliseconds kMinTime(fQuick ? 20 : 200);
+
+	Clock::duration best = Clock::duration::max();
+	Clock::time_point start = Clock::now();
+	for (int32_t run = 0; run < kMaxRuns; run++) {
+		Clock::time_point runStart = Clock::now();
+		function();
+		Clock::duration time = Clock::now() - runStart;
+		if (time < best)
+			best = time;
+
+		if (run + 1 >= kMinRuns && Clock::now() - start >= kMinTime)
+			break;
+	}
+
+	_Add(name, std::chrono::duration<double, std::micro>(best).count() / operations);
+}
+
+
+#endif // BENCH_H
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "Bench.h"
+#include "IgnoreRules.h"
+
+#include <string>
+#include <vector>
+
+
+// 1000 ignore rules checked against 50k paths: compiling the rules, one
+// walk per path through the trie, the same with patterns among the rules,
+// and for comparison checking every rule per path one after the other,
+// like IgnoreListItem::Ignores() did.
+
+static const int32_t kRuleCount = 1000;
+static const int32_t kPathCount = 50000;
+static const int32_t kPatternCount = 100;
+
+static const char* kRoots[] = {
+	"/boot/system/apps",
+	"/boot/system/bin",
+	"/boot/system/add-ons",
+	"/boot/home/config/non-packaged/apps",
+	"/boot/home/Desktop/projects"
+};
+static const int32_t kRootCount = sizeof(kRoots) / sizeof(kRoots[0]);
+
+
+struct Rule {
+	std::string				path;
+	bool					isDirectory;
+};
+
+
+class Random {
+public:
+	Random(uint32_t seed)
+		:
+		fState(seed)
+	{
+	}
+
+	uint32_t Next(uint32_t range)
+	{
+		fState ^= fState << 13;
+		fState ^= fState >> 17;
+		fState ^= fState << 5;
+		return fState % range;
+	}
+
+private:
+	uint32_t fState;
+};
+
+
+static std::string
+random_path(Random& random, int32_t depth)
+{
+	std::string path(kRoots[random.Next(kRootCount)]);
+	for (int32_t i = 0; i < depth; i++)
+		path.append("/d").append(std::to_string(random.Next(40)));
+	return path;
+}
+
+
+// The rules are a mix of folders and single files, about a third of the
+// paths lie below one of them
+static void
+generate(std::vector<Rule>& rules, std::vector<std::string>& patterns,
+	std::vector<std::string>& paths)
+{
+	Random random(2463534242u);
+	for (int32_t i = 0; i < kRuleCount; i++) {
+		Rule rule;
+		rule.isDirectory = random.Next(3) != 0;
+		rule.path = random_path(random, 1 + random.Next(3));
+		if (!rule.isDirectory)
+			rule.path.append("/App").append(std::to_string(random.Next(100)));
+		rules.push_back(rule);
+	}
+
+	const char* shapes[] = { "*.so", "lib*", "*test*", "[Tt]mp?", "d1?", "*~" };
+	for (int32_t i = 0; i < kPatternCount; i++) {
+		std::string pattern(shapes[i % 6]);
+		pattern.append(std::to_string(i));
+		patterns.push_back(pattern);
+	}
+
+	for (int32_t i = 0; i < kPathCount; i++) {
+		std::string path = random_path(random, 2 + random.Next(4));
+		path.append("/App").append(std::to_string(random.Next(100)));
+		paths.push_back(path);
+	}
+}
+
+
+static bool
+ignored_per_rule(const std::vector<Rule>& rules, const std::string& path)
+{
+	for (size_t i = 0; i < rules.size(); i++) {
+		const std::string& rule = rules[i].path;
+		if (path.compare(0, rule.size(), rule) != 0)
+			continue;
+		if (path.size() == rule.size()
+			|| (rules[i].isDirectory && path[rule.size()] == '/'))
+			return true;
+	}
+	return false;
+}
+
+
+void
+bench_ignore_rules(BenchResults& results)
+{
+	std::vector<Rule> rules;
+	std::vector<std::string> patterns;
+	std::vector<std::string> paths;
+	generate(rules, patterns, paths);
+
+	IgnoreRules trie;
+	results.Measure("ignore/1000/compile", 1, [&]() {
+		trie.MakeEmpty();
+		for (size_t i = 0; i < rules.size(); i++)
+			trie.AddRule(rules[i].path.c_str(), rules[i].isDirectory);
+	});
+
+	volatile int32_t sink = 0;
+	results.Measure("ignore/1000x50k/trie", kPathCount, [&]() {
+		int32_t ignored = 0;
+		for (size_t i = 0; i < paths.size(); i++)
+			ignored += trie.Ignores(paths[i].c_str());
+		sink = ignored;
+	});
+
+	// Patterns shouldn't make each path cost much more
+	for (size_t i = 0; i < patterns.size(); i++)
+		trie.AddPattern(patterns[i].c_str());
+	results.Measure("ignore/1000x50k/patterns", kPathCount, [&]() {
+		int32_t ignored = 0;
+		for (size_t i = 0; i < paths.size(); i++)
+			ignored += trie.Ignores(paths[i].c_str());
+		sink = ignored;
+	});
+
+	results.Measure("ignore/1000x50k/per-rule", kPathCount, [&]() {
+		int32_t ignored = 0;
+		for (size_t i = 0; i < paths.size(); i++)
+			ignored += ignored_per_rule(rules, paths[i]);
+		sink = ignored;
+	});
+}
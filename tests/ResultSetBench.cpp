@@ -0,0 +1,114 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "Bench.h"
+#include "ResultSet.h"
+
+#include <vector>
+
+
+// Combining search conditions over a 1M entry app list, and for comparison
+// the same evaluated entry by entry with a branch per condition, like the
+// filtering before ResultSet did.
+
+static const int32_t kCount = 1000000;
+
+
+// Sets about one in every "every" entries, the same ones on every run
+static void
+fill(ResultSet& set, std::vector<char>& flags, uint32_t every, uint32_t seed)
+{
+	set.SetCount(kCount);
+	flags.assign(kCount, 0);
+	uint32_t state = seed;
+	for (int32_t i = 0; i < kCount; i++) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		if (state % every == 0) {
+			set.Set(i);
+			flags[i] = 1;
+		}
+	}
+}
+
+
+void
+bench_result_set(BenchResults& results)
+{
+	// What a short query matches, the favorites, and the ignored entries
+	ResultSet matched;
+	ResultSet favorites;
+	ResultSet ignored;
+	std::vector<char> matchedFlags;
+	std::vector<char> favoriteFlags;
+	std::vector<char> ignoredFlags;
+	fill(matched, matchedFlags, 20, 2463534242u);
+	fill(favorites, favoriteFlags, 500, 88675123u);
+	fill(ignored, ignoredFlags, 4, 123456789u);
+
+	ResultSet scratch(kCount);
+	results.Measure("resultset/1M/and", 1, [&]() {
+		scratch.SetAll();
+		scratch.And(matched);
+	});
+	results.Measure("resultset/1M/or", 1, [&]() {
+		scratch.ClearAll();
+		scratch.Or(matched);
+	});
+	results.Measure("resultset/1M/andnot", 1, [&]() {
+		scratch.SetAll();
+		scratch.AndNot(ignored);
+	});
+
+	volatile int32_t sink = 0;
+	results.Measure("resultset/1M/count", 1, [&]() { sink = matched.CountSet(); });
+	results.Measure("resultset/1M/iterate", 1, [&]() {
+		int32_t sum = 0;
+		for (int32_t i = matched.NextSet(0); i >= 0; i = matched.NextSet(i + 1))
+			sum += i;
+		sink = sum;
+	});
+
+	// Favorites first: matched and not ignored, split into favorites and
+	// the rest, both walked in order
+	std::vector<int32_t> order;
+	order.reserve(kCount);
+	ResultSet rest(kCount);
+	ResultSet first(kCount);
+	results.Measure("resultset/1M/filter", 1, [&]() {
+		order.clear();
+		rest.ClearAll();
+		rest.Or(matched);
+		rest.AndNot(ignored);
+		first.ClearAll();
+		first.Or(rest);
+		first.And(favorites);
+		rest.AndNot(favorites);
+		for (int32_t i = first.NextSet(0); i >= 0; i = first.NextSet(i + 1))
+			order.push_back(i);
+		for (int32_t i = rest.NextSet(0); i >= 0; i = rest.NextSet(i + 1))
+			order.push_back(i);
+	});
+
+	std::vector<int32_t> others;
+	others.reserve(kCount);
+	results.Measure("resultset/1M/filter-per-entry", 1, [&]() {
+		order.clear();
+		others.clear();
+		for (int32_t i = 0; i < kCount; i++) {
+			if (!matchedFlags[i] || ignoredFlags[i])
+				continue;
+			if (favoriteFlags[i])
+				order.push_back(i);
+			else
+				others.push_back(i);
+		}
+		order.insert(order.end(), others.begin(), others.end());
+	});
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "Bench.h"
+#include "SearchEngine.h"
+#include "SyntheticCatalog.h"
+#include "TestCatalog.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+
+// What the app does with its list on synthetic catalogs of different sizes:
+// building it in display order, evaluating the ignore list, and searching
+// while a query is typed.
+
+// The default ignore list, and a few patterns
+static const char* kIgnoreDirectories[] = {
+	"/boot/system/add-ons",
+	"/boot/system/bin",
+	"/boot/system/data",
+	"/boot/system/lib",
+	"/boot/system/servers",
+	"/boot/home/config/non-packaged/bin"
+};
+static const char* kIgnorePatterns[] = { "*Tracker*", "/boot/home/Desktop/**/build" };
+
+// Typed one letter at a time, each prefix is a search
+static const char* kQueries[] = { "ma", "pix", "tera", "*edit", "ка" };
+
+
+struct Entry {
+	std::string				name;
+	std::string				path;
+	std::string				sortKey;
+	std::string				sortPath;
+	bool					isFavorite;
+};
+
+
+static std::string
+ascii_lower(const std::string& string)
+{
+	std::string lower(string);
+	for (size_t i = 0; i < lower.size(); i++) {
+		if (lower[i] >= 'A' && lower[i] <= 'Z')
+			lower[i] += 'a' - 'A';
+	}
+	return lower;
+}
+
+
+static void
+generate(int32_t count, std::vector<Entry>& entries)
+{
+	SyntheticCatalog catalog(count);
+	Entry entry;
+	while (catalog.GetNext(entry.name, entry.path)) {
+		entry.isFavorite = catalog.Random(500) == 0;
+		entries.push_back(entry);
+	}
+}
+
+
+// Like AppListItem::Compare()
+static bool
+sorts_before(const Entry* a, const Entry* b)
+{
+	int cmp = strcmp(a->sortKey.c_str(), b->sortKey.c_str());
+	if (cmp != 0)
+		return cmp < 0;
+	return strcmp(a->sortPath.c_str(), b->sortPath.c_str()) < 0;
+}
+
+
+static void
+sort(const std::vector<Entry>& entries, std::vector<const Entry*>& order)
+{
+	order.resize(entries.size());
+	for (size_t i = 0; i < entries.size(); i++)
+		order[i] = &entries[i];
+	std::sort(order.begin(), order.end(), &sorts_before);
+}
+
+
+// Like AppListItem without a collator: the sort key is the lowercase name,
+// then the lowercase path tells entries of the same name apart
+static void
+build(std::vector<Entry>& entries, TestCatalog& catalog)
+{
+	for (size_t i = 0; i < entries.size(); i++) {
+		entries[i].sortKey = ascii_lower(entries[i].name);
+		entries[i].sortPath = ascii_lower(entries[i].path);
+	}
+
+	std::vector<const Entry*> order;
+	sort(entries, order);
+
+	catalog.MakeEmpty();
+	for (size_t i = 0; i < order.size(); i++)
+		catalog.Add(order[i]->name, order[i]->path, order[i]->isFavorite);
+}
+
+
+static void
+add_ignore_rules(IgnoreRules& rules)
+{
+	for (size_t i = 0; i < sizeof(kIgnoreDirectories) / sizeof(kIgnoreDirectories[0]); i++)
+		rules.AddRule(kIgnoreDirectories[i], true);
+	for (size_t i = 0; i < sizeof(kIgnorePatterns) / sizeof(kIgnorePatterns[0]); i++)
+		rules.AddPattern(kIgnorePatterns[i]);
+}
+
+
+static int64_t
+type_queries(SearchEngine& engine, const TestCatalog& catalog,
+	std::vector<SearchMatch>& matches)
+{
+	int64_t keystrokes = 0;
+	SearchQuery query;
+	for (size_t i = 0; i < sizeof(kQueries) / sizeof(kQueries[0]); i++) {
+		std::string typed;
+		for (const char* c = kQueries[i]; *c != '\0'; c++) {
+			typed += *c;
+			// Multi-byte characters are typed at once
+			if ((c[1] & 0xc0) == 0x80)
+				continue;
+
+			query.SetTo(typed.c_str(), true);
+			engine.Search(catalog, query, true, true, matches);
+			keystrokes++;
+		}
+	}
+	return keystrokes;
+}
+
+
+static void
+bench_catalog(BenchResults& results, int32_t count, const char* size)
+{
+	std::vector<Entry> entries;
+	generate(count, entries);
+
+	TestCatalog catalog;
+	std::string prefix("catalog/");
+	prefix += size;
+
+	results.Measure(prefix + "/build", 1, [&]() { build(entries, catalog); });
+
+	// Sorting alone, by the keys the build computed
+	std::vector<const Entry*> order;
+	results.Measure(prefix + "/sort", 1, [&]() { sort(entries, order); });
+
+	IgnoreRules rules;
+	add_ignore_rules(rules);
+	SearchEngine engine;
+	results.Measure(prefix + "/ignore", 1, [&]() { engine.ApplyIgnoreRules(catalog, rules); });
+
+	std::vector<SearchMatch> matches;
+	int64_t keystrokes = type_queries(engine, catalog, matches);
+	results.Measure(prefix + "/keystroke", keystrokes,
+		[&]() { type_queries(engine, catalog, matches); });
+
+	SearchQuery all("*", true);
+	results.Measure(prefix + "/show-all", 1,
+		[&]() { engine.Search(catalog, all, true, true, matches); });
+}
+
+
+void
+bench_search(BenchResults& results)
+{
+	bench_catalog(results, 10000, "10k");
+	bench_catalog(results, 100000, "100k");
+	if (!results.IsQuick())
+		bench_catalog(results, 1000000, "1M");
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "SearchEngine.h"
+#include "Test.h"
+#include "TestCatalog.h"
+
+
+// Checks the engine's parts on small cases whose results are known, the
+// randomized comparison with the reference is in SearchOracleTest.
+
+
+class CancelAfter : public SearchCanceller {
+public:
+	CancelAfter(int32_t calls)
+		:
+		fCalls(calls)
+	{
+	}
+
+	bool IsCancelled() const { return fCalls-- <= 0; }
+
+private:
+	mutable int32_t fCalls;
+};
+
+
+static std::vector<int32_t>
+indices(const std::vector<SearchMatch>& matches)
+{
+	std::vector<int32_t> indices;
+	for (size_t i = 0; i < matches.size(); i++)
+		indices.push_back(matches[i].index);
+	return indices;
+}
+
+
+static void
+test_query()
+{
+	SearchQuery query("me", true);
+	CHECK(query.Matches("MediaPlayer"));
+	CHECK(query.Matches("me"));
+	CHECK(!query.Matches("m"));
+	CHECK(!query.Matches("HomeTerm"));
+
+	query.SetTo("ME", false);
+	CHECK(query.Matches("HomeTerm"));
+	CHECK(query.Matches("meme"));
+	CHECK(!query.Matches("Mail"));
+
+	// A leading "*" searches anywhere, even from the start
+	query.SetTo("*term", true);
+	CHECK(query.Matches("Terminal"));
+	CHECK(query.Matches("HomeTerm"));
+	CHECK(!query.Matches("Ter"));
+
+	query.SetTo("*", true);
+	CHECK(query.MatchesAll());
+	CHECK(query.Matches(""));
+
+	query.SetTo("", true);
+	CHECK(!query.MatchesAll());
+	CHECK(query.Matches("anything"));
+
+	// Only ASCII letters ignore case
+	query.SetTo("\xc3\xa9", true);
+	CHECK(query.Matches("\xc3\xa9t\xc3\xa9"));
+	CHECK(!query.Matches("\xc3\x89t\xc3\xa9"));
+}
+
+
+static void
+test_result_set()
+{
+	ResultSet set(130);
+	CHECK(set.Count() == 130);
+	CHECK(set.CountSet() == 0);
+	CHECK(set.NextSet(0) == -1);
+
+	set.Set(0);
+	set.Set(64);
+	set.Set(129);
+	CHECK(set.Test(64));
+	CHECK(!set.Test(63));
+	CHECK(set.CountSet() == 3);
+	CHECK(set.NextSet(1) == 64);
+	CHECK(set.NextSet(65) == 129);
+	CHECK(set.NextSet(130) == -1);
+
+	set.Clear(64);
+	CHECK(set.NextSet(1) == 129);
+
+	// Bits past the end stay cleared
+	set.SetAll();
+	CHECK(set.CountSet() == 130);
+
+	ResultSet other(130);
+	other.Set(3);
+	other.Set(100);
+	set.AndNot(other);
+	CHECK(set.CountSet() == 128);
+	CHECK(!set.Test(3));
+
+	set.ClearAll();
+	set.Set(5);
+	set.Or(other);
+	CHECK(set.CountSet() == 3);
+	set.And(other);
+	CHECK(set.CountSet() == 2);
+	CHECK(set.NextSet(0) == 3);
+
+	// Past the other set's count, its indices aren't set
+	ResultSet shorter(70);
+	shorter.SetAll();
+	set.SetAll();
+	set.AndNot(shorter);
+	CHECK(set.CountSet() == 60);
+	set.SetAll();
+	set.And(shorter);
+	CHECK(set.CountSet() == 70);
+	shorter.ClearAll();
+	shorter.Or(set);
+	CHECK(shorter.CountSet() == 70);
+	CHECK(shorter.NextSet(70) == -1);
+}
+
+
+static void
+test_ignore_rules()
+{
+	IgnoreRules rules;
+	CHECK(rules.IsEmpty());
+	CHECK(!rules.Ignores("/boot/system/apps/Mail"));
+
+	rules.AddRule("/boot/system/bin", true);
+	rules.AddRule("/boot/system/apps/Mail", false);
+	CHECK(!rules.IsEmpty());
+
+	CHECK(rules.Ignores("/boot/system/bin/ls"));
+	CHECK(rules.Ignores("/boot/system/bin/x/y"));
+	CHECK(!rules.Ignores("/boot/system/binaries/ls"));
+	CHECK(!rules.Ignores("/boot/system"));
+	CHECK(rules.Ignores("/boot/system/apps/Mail"));
+	CHECK(!rules.Ignores("/boot/system/apps/Mail/x"));
+	CHECK(!rules.Ignores("/boot/system/apps/MailDaemon"));
+
+	// Rules are literal paths, even with characters patterns use
+	rules.AddRule("/boot/home/[old] apps", true);
+	rules.AddRule("/boot/home/Who?", false);
+	CHECK(rules.Ignores("/boot/home/[old] apps/Foo"));
+	CHECK(!rules.Ignores("/boot/home/o apps/Foo"));
+	CHECK(rules.Ignores("/boot/home/Who?"));
+	CHECK(!rules.Ignores("/boot/home/Whom"));
+
+	// Patterns without a leading "/" match at any depth
+	rules.AddPattern("*.so");
+	CHECK(rules.Ignores("/boot/home/lib/libfoo.so"));
+	CHECK(rules.Ignores("/boot/home/libfoo.so/Foo"));
+	CHECK(!rules.Ignores("/boot/home/libfoo.sos"));
+
+	rules.AddPattern("/boot/*/add-ons/**/[Tt]est?");
+	CHECK(rules.Ignores("/boot/system/add-ons/Tracker/Test1"));
+	CHECK(rules.Ignores("/boot/home/add-ons/test2"));
+	CHECK(!rules.Ignores("/boot/home/add-ons/Tester"));
+	CHECK(!rules.Ignores("/boot/home/config/add-ons/Test1"));
+
+	rules.AddPattern("[!a-z]*");
+	CHECK(rules.Ignores("/boot/home/_private"));
+	CHECK(!rules.Ignores("/boot/home/apps"));
+
+	rules.MakeEmpty();
+	CHECK(rules.IsEmpty());
+	CHECK(!rules.Ignores("/boot/system/bin/ls"));
+}
+
+
+static void
+test_search()
+{
+	TestCatalog catalog;
+	catalog.Add("Mail", "/boot/system/apps/Mail");
+	catalog.Add("MediaPlayer", "/boot/system/apps/MediaPlayer", true);
+	catalog.Add("Magnify", "/boot/system/apps/Magnify");
+	catalog.Add("mkdir", "/boot/system/bin/mkdir", true);
+	catalog.Add("Terminal", "/boot/system/apps/Terminal");
+
+	IgnoreRules rules;
+	rules.AddRule("/boot/system/bin", true);
+
+	SearchEngine engine;
+	engine.ApplyIgnoreRules(catalog, rules);
+	CHECK(engine.Ignored().Count() == 5);
+	CHECK(engine.Ignored().Test(3));
+
+	std::vector<SearchMatch> matches;
+	CHECK(engine.Search(catalog, SearchQuery("m", true), true, false, matches));
+	CHECK(indices(matches) == std::vector<int32_t>({ 0, 1, 2 }));
+	CHECK(!matches[0].isFavorite && matches[1].isFavorite);
+
+	CHECK(engine.Search(catalog, SearchQuery("m", true), false, true, matches));
+	CHECK(indices(matches) == std::vector<int32_t>({ 1, 3, 0, 2 }));
+	CHECK(matches[1].isFavorite && !matches[2].isFavorite);
+
+	CHECK(engine.Search(catalog, SearchQuery("*a", true), true, true, matches));
+	CHECK(indices(matches) == std::vector<int32_t>({ 1, 0, 2, 4 }));
+
+	CHECK(engine.Search(catalog, SearchQuery("*", true), true, false, matches));
+	CHECK(matches.size() == 4);
+
+	CHECK(engine.Search(catalog, SearchQuery("x", true), true, false, matches));
+	CHECK(matches.empty());
+
+	// Cancelled searches return nothing
+	CancelAfter canceller(0);
+	CHECK(!engine.Search(catalog, SearchQuery("m", true), true, false, matches,
+		&canceller));
+	CHECK(matches.empty());
+
+	// An empty list searches fine, too
+	catalog.MakeEmpty();
+	engine.ApplyIgnoreRules(catalog, rules);
+	CHECK(engine.Search(catalog, SearchQuery("m", true), true, true, matches));
+	CHECK(matches.empty());
+}
+
+
+int
+main()
+{
+	test_query();
+	test_result_set();
+	test_ignore_rules();
+	test_search();
+
+	return test_result("SearchEngineTest");
+}
@@ -0,0 +1,579 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "SearchOracle.h"
+#include "TestCatalog.h"
+
+#include <fnmatch.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <algorithm>
+
+
+namespace {
+
+
+struct TestRule {
+	std::string				path;
+	bool					isDirectory;
+};
+
+
+// One random case, everything the app's way and the oracle are given. The
+// entries are in no particular order, like the volumes' queries find them.
+struct TestCase {
+	std::vector<std::string> names;
+	std::vector<std::string> paths;
+	std::vector<bool>		favorites;
+	std::vector<TestRule>	rules;
+	std::vector<std::string> patterns;
+	std::string				text;
+	bool					searchFromStart;
+	bool					applyIgnore;
+	bool					favoritesFirst;
+};
+
+
+class Random {
+public:
+	Random(uint32_t seed)
+		:
+		fState(seed != 0 ? seed : 1)
+	{
+	}
+
+	uint32_t Next(uint32_t range)
+	{
+		fState ^= fState << 13;
+		fState ^= fState >> 17;
+		fState ^= fState << 5;
+		return fState % range;
+	}
+
+private:
+	uint32_t fState;
+};
+
+
+// Few different letters, so names share prefixes and substrings a lot.
+// Includes case, a wildcard, and letters that only differ by accent.
+const char* kLetters[] = {
+	"a", "A", "b", "B", "c", "e", "*", " ", "\xc3\xa9", "\xc3\x89"
+};
+const int32_t kLetterCount = sizeof(kLetters) / sizeof(kLetters[0]);
+const char* kFolders[] = { "/d0", "/d0/d1", "/d1", "/d1/d0" };
+const int32_t kFolderCount = sizeof(kFolders) / sizeof(kFolders[0]);
+// Pieces of pattern components, "**" is always a component of its own
+const char* kPatternPieces[] = {
+	"*", "?", "a", "A", "b", "d", "0", "1", "[ab]", "[!a]", "[0-9]", "[d-e]", "["
+};
+const int32_t kPatternPieceCount = sizeof(kPatternPieces) / sizeof(kPatternPieces[0]);
+
+
+std::string
+ascii_lower(const std::string& string)
+{
+	std::string lower(string);
+	for (size_t i = 0; i < lower.size(); i++) {
+		if (lower[i] >= 'A' && lower[i] <= 'Z')
+			lower[i] += 'a' - 'A';
+	}
+	return lower;
+}
+
+
+// Stands in for BCollator::GetSortKey(): letters sort together regardless
+// of case and accent, then accents tell them apart, then case. The levels
+// are separated by 0x01 bytes. Like in real keys, the letters' weights go
+// beyond 0x7f, so keys must compare as unsigned bytes.
+std::string
+sort_key(const std::string& name)
+{
+	std::string primary;
+	std::string accents;
+	std::string cases;
+	for (size_t i = 0; i < name.size(); i++) {
+		unsigned char c = name[i];
+		unsigned char accent = 0x80;
+		bool upper = c >= 'A' && c <= 'Z';
+		if (c == 0xc3 && i + 1 < name.size()
+			&& ((unsigned char)name[i + 1] == 0xa9 || (unsigned char)name[i + 1] == 0x89)) {
+			upper = (unsigned char)name[i + 1] == 0x89;
+			c = 'e';
+			accent = 0x90;
+			i++;
+		} else if (upper)
+			c += 'a' - 'A';
+
+		// Letters weigh from 0x7e on, everything else keeps its byte
+		if (c >= 'a' && c <= 'z')
+			c = 0x7e + (c - 'a');
+		primary += (char)c;
+		accents += (char)accent;
+		cases += (char)(upper ? 0x82 : 0x81);
+	}
+	return primary + '\x01' + accents + '\x01' + cases;
+}
+
+
+void
+split_path(const std::string& path, std::vector<std::string>& components)
+{
+	components.clear();
+	size_t start = 0;
+	while (start < path.size()) {
+		size_t end = path.find('/', start);
+		if (end == std::string::npos)
+			end = path.size();
+		if (end > start)
+			components.push_back(path.substr(start, end - start));
+		start = end + 1;
+	}
+}
+
+
+// Whether the pattern's components match the path's from "index" to "end",
+// "**" matches any number of them
+bool
+matches_components(const std::vector<std::string>& pattern, size_t patternIndex,
+	const std::vector<std::string>& path, size_t index, size_t end)
+{
+	if (patternIndex == pattern.size())
+		return index == end;
+
+	if (pattern[patternIndex] == "**") {
+		for (size_t next = index; next <= end; next++) {
+			if (matches_components(pattern, patternIndex + 1, path, next, end))
+				return true;
+		}
+		return false;
+	}
+
+	return index < end
+		&& fnmatch(pattern[patternIndex].c_str(), path[index].c_str(), FNM_NOESCAPE) == 0
+		&& matches_components(pattern, patternIndex + 1, path, index + 1, end);
+}
+
+
+// The ignore list the simple way: rules compare strings, patterns are
+// matched component by component with fnmatch() against the path and each
+// of its parents. Patterns without a leading "/" match at any depth.
+bool
+is_ignored(const TestCase& test, const std::string& path)
+{
+	for (size_t i = 0; i < test.rules.size(); i++) {
+		const std::string& rule = test.rules[i].path;
+		if (path == rule)
+			return true;
+		if (test.rules[i].isDirectory && path.compare(0, rule.size(), rule) == 0
+			&& path[rule.size()] == '/')
+			return true;
+	}
+
+	std::vector<std::string> components;
+	split_path(path, components);
+	for (size_t i = 0; i < test.patterns.size(); i++) {
+		std::string pattern = test.patterns[i];
+		if (pattern[0] != '/')
+			pattern.insert(0, "**/");
+
+		std::vector<std::string> patternComponents;
+		split_path(pattern, patternComponents);
+		for (size_t end = 1; end <= components.size(); end++) {
+			if (matches_components(patternComponents, 0, components, 0, end))
+				return true;
+		}
+	}
+	return false;
+}
+
+
+std::string
+random_pattern(Random& random)
+{
+	std::string pattern;
+	if (random.Next(3) == 0)
+		pattern = "/";
+
+	int32_t componentCount = 1 + random.Next(3);
+	for (int32_t i = 0; i < componentCount; i++) {
+		if (i > 0)
+			pattern += "/";
+		if (random.Next(5) == 0) {
+			pattern += "**";
+			continue;
+		}
+		for (int32_t length = 1 + random.Next(3); length > 0; length--)
+			pattern += kPatternPieces[random.Next(kPatternPieceCount)];
+	}
+	return pattern;
+}
+
+
+TestCase
+random_case(Random& random)
+{
+	TestCase test;
+	int32_t count = random.Next(12);
+	for (int32_t i = 0; i < count; i++) {
+		std::string name;
+		int32_t length = random.Next(6);
+		for (int32_t j = 0; j < length; j++)
+			name += kLetters[random.Next(kLetterCount)];
+
+		// Apps are unique by their path, even those with the same name
+		test.names.push_back(name);
+		test.paths.push_back(std::string(kFolders[random.Next(kFolderCount)]) + "/"
+			+ std::to_string(i) + "/" + name);
+		test.favorites.push_back(random.Next(4) == 0);
+	}
+
+	int32_t ruleCount = random.Next(3);
+	for (int32_t i = 0; i < ruleCount; i++) {
+		TestRule rule;
+		rule.isDirectory = random.Next(2) == 0;
+		if (rule.isDirectory || count == 0)
+			rule.path = kFolders[random.Next(kFolderCount)];
+		else
+			rule.path = test.paths[random.Next(count)];
+		test.rules.push_back(rule);
+	}
+
+	int32_t patternCount = random.Next(3);
+	for (int32_t i = 0; i < patternCount; i++)
+		test.patterns.push_back(random_pattern(random));
+
+	// Mostly pieces of names, with their case changed now and then
+	switch (random.Next(6)) {
+		case 0:
+			test.text = "*";
+			break;
+		case 1:
+			for (int32_t length = random.Next(3); length > 0; length--)
+				test.text += kLetters[random.Next(kLetterCount)];
+			break;
+		default:
+			if (count > 0) {
+				const std::string& name = test.names[random.Next(count)];
+				size_t start = random.Next(name.size() + 1);
+				test.text = name.substr(start, random.Next(name.size() - start + 1));
+				for (size_t i = 0; i < test.text.size(); i++) {
+					char& c = test.text[i];
+					if (random.Next(3) == 0 && ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')))
+						c ^= 0x20;
+				}
+			}
+			break;
+	}
+	if (random.Next(4) == 0)
+		test.text.insert(0, "*");
+
+	test.searchFromStart = random.Next(2) == 0;
+	test.applyIgnore = random.Next(4) != 0;
+	test.favoritesFirst = random.Next(2) == 0;
+	return test;
+}
+
+
+// What the app does: sort the list into display order with the collator's
+// keys, compile the ignore list, search with the engine. The matches are
+// mapped back to the entries of the test case.
+void
+run_app(const TestCase& test, std::vector<SearchMatch>& matches)
+{
+	int32_t count = test.names.size();
+	std::vector<std::string> keys(count);
+	std::vector<std::string> sortPaths(count);
+	std::vector<int32_t> order(count);
+	for (int32_t i = 0; i < count; i++) {
+		keys[i] = sort_key(test.names[i]);
+		sortPaths[i] = ascii_lower(test.paths[i]);
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&](int32_t a, int32_t b) {
+		return SearchEngine::CompareEntries(keys[a].c_str(), sortPaths[a].c_str(),
+			keys[b].c_str(), sortPaths[b].c_str()) < 0;
+	});
+
+	TestCatalog catalog;
+	for (int32_t i = 0; i < count; i++)
+		catalog.Add(test.names[order[i]], test.paths[order[i]], test.favorites[order[i]]);
+
+	IgnoreRules rules;
+	for (size_t i = 0; i < test.rules.size(); i++)
+		rules.AddRule(test.rules[i].path.c_str(), test.rules[i].isDirectory);
+	for (size_t i = 0; i < test.patterns.size(); i++)
+		rules.AddPattern(test.patterns[i].c_str());
+
+	SearchEngine engine;
+	engine.ApplyIgnoreRules(catalog, rules);
+	engine.Search(catalog, SearchQuery(test.text.c_str(), test.searchFromStart),
+		test.applyIgnore, test.favoritesFirst, matches);
+
+	for (size_t i = 0; i < matches.size(); i++)
+		matches[i].index = order[matches[i].index];
+}
+
+
+void
+run_oracle(const TestCase& test, std::vector<SearchMatch>& matches)
+{
+	std::vector<OracleEntry> entries(test.names.size());
+	for (size_t i = 0; i < entries.size(); i++) {
+		entries[i].name = test.names[i];
+		entries[i].path = test.paths[i];
+		entries[i].sortKey = sort_key(test.names[i]);
+		entries[i].isFavorite = test.favorites[i];
+	}
+
+	SearchOracle::Search(entries, test.text.c_str(), test.searchFromStart,
+		test.applyIgnore, test.favoritesFirst,
+		[&test](const std::string& path) { return is_ignored(test, path); },
+		matches);
+}
+
+
+bool
+fails(const TestCase& test)
+{
+	std::vector<SearchMatch> expected;
+	std::vector<SearchMatch> actual;
+	run_oracle(test, expected);
+	run_app(test, actual);
+	return !SearchOracle::Equals(expected, actual);
+}
+
+
+void
+set_name(TestCase& test, size_t index, const std::string& name)
+{
+	test.names[index] = name;
+	std::string& path = test.paths[index];
+	path.replace(path.rfind('/') + 1, std::string::npos, name);
+}
+
+
+// Removes whatever it can from a failing case while it keeps failing:
+// entries, rules, patterns, and letters of the query, the names and the
+// patterns
+void
+shrink(TestCase& test)
+{
+	bool shrunk = true;
+	while (shrunk) {
+		shrunk = false;
+
+		for (size_t i = test.names.size(); i-- > 0;) {
+			TestCase smaller = test;
+			smaller.names.erase(smaller.names.begin() + i);
+			smaller.paths.erase(smaller.paths.begin() + i);
+			smaller.favorites.erase(smaller.favorites.begin() + i);
+			if (fails(smaller)) {
+				test = smaller;
+				shrunk = true;
+			}
+		}
+
+		for (size_t i = test.rules.size(); i-- > 0;) {
+			TestCase smaller = test;
+			smaller.rules.erase(smaller.rules.begin() + i);
+			if (fails(smaller)) {
+				test = smaller;
+				shrunk = true;
+			}
+		}
+
+		for (size_t i = test.patterns.size(); i-- > 0;) {
+			TestCase smaller = test;
+			smaller.patterns.erase(smaller.patterns.begin() + i);
+			if (fails(smaller)) {
+				test = smaller;
+				shrunk = true;
+			}
+		}
+
+		for (size_t i = test.text.size(); i-- > 0;) {
+			TestCase smaller = test;
+			smaller.text.erase(i, 1);
+			if (fails(smaller)) {
+				test = smaller;
+				shrunk = true;
+			}
+		}
+
+		for (size_t i = 0; i < test.names.size(); i++) {
+			for (size_t j = test.names[i].size(); j-- > 0;) {
+				TestCase smaller = test;
+				std::string name = smaller.names[i];
+				set_name(smaller, i, name.erase(j, 1));
+				if (fails(smaller)) {
+					test = smaller;
+					shrunk = true;
+				}
+			}
+		}
+
+		for (size_t i = 0; i < test.patterns.size(); i++) {
+			for (size_t j = test.patterns[i].size(); j-- > 0;) {
+				TestCase smaller = test;
+				smaller.patterns[i].erase(j, 1);
+				if (!smaller.patterns[i].empty() && fails(smaller)) {
+					test = smaller;
+					shrunk = true;
+				}
+			}
+		}
+	}
+}
+
+
+// Shrinking works on bytes, so it may leave partial UTF-8 characters
+std::string
+escaped(const std::string& string)
+{
+	std::string escaped;
+	for (size_t i = 0; i < string.size(); i++) {
+		unsigned char c = string[i];
+		if (c >= 0x80 || c < 0x20 || c == '"' || c == '\\') {
+			char hex[8];
+			snprintf(hex, sizeof(hex), "\\x%02x", c);
+			escaped += hex;
+		} else
+			escaped += c;
+	}
+	return escaped;
+}
+
+
+void
+print_matches(FILE* report, const char* label, const TestCase& test,
+	const std::vector<SearchMatch>& matches)
+{
+	fprintf(report, "  %s:", label);
+	for (size_t i = 0; i < matches.size(); i++) {
+		fprintf(report, " \"%s\"%s", escaped(test.paths[matches[i].index]).c_str(),
+			matches[i].isFavorite ? "(fav)" : "");
+	}
+	fprintf(report, "\n");
+}
+
+
+void
+print_case(FILE* report, const TestCase& test)
+{
+	fprintf(report, "  query \"%s\"%s%s%s\n", escaped(test.text).c_str(),
+		test.searchFromStart ? ", from start" : ", anywhere",
+		test.applyIgnore ? ", ignoring" : "",
+		test.favoritesFirst ? ", favorites first" : "");
+	for (size_t i = 0; i < test.names.size(); i++) {
+		fprintf(report, "  entry \"%s\" %s, key \"%s\"%s\n", escaped(test.names[i]).c_str(),
+			escaped(test.paths[i]).c_str(), escaped(sort_key(test.names[i])).c_str(),
+			test.favorites[i] ? " (fav)" : "");
+	}
+	for (size_t i = 0; i < test.rules.size(); i++) {
+		fprintf(report, "  ignore %s%s\n", escaped(test.rules[i].path).c_str(),
+			test.rules[i].isDirectory ? "/" : "");
+	}
+	for (size_t i = 0; i < test.patterns.size(); i++)
+		fprintf(report, "  ignore pattern %s\n", escaped(test.patterns[i]).c_str());
+
+	std::vector<SearchMatch> expected;
+	std::vector<SearchMatch> actual;
+	run_oracle(test, expected);
+	run_app(test, actual);
+	print_matches(report, "expected", test, expected);
+	print_matches(report, "app", test, actual);
+}
+
+
+}	// namespace
+
+
+/*static*/ void
+SearchOracle::Search(const std::vector<OracleEntry>& entries, const char* text,
+	bool searchFromStart, bool applyIgnore, bool favoritesFirst,
+	const IgnoreFunction& isIgnored, std::vector<SearchMatch>& matches)
+{
+	matches.clear();
+
+	bool showAll = strcmp(text, "*") == 0;
+	if (text[0] == '*') {
+		searchFromStart = false;
+		text++;
+	}
+	std::string lowerText = ascii_lower(text);
+
+	for (size_t i = 0; i < entries.size(); i++) {
+		std::string name = ascii_lower(entries[i].name);
+		bool found;
+		if (showAll)
+			found = true;
+		else if (searchFromStart)
+			found = name.compare(0, lowerText.size(), lowerText) == 0;
+		else
+			found = name.find(lowerText) != std::string::npos;
+
+		if (!found || (applyIgnore && isIgnored(entries[i].path)))
+			continue;
+
+		SearchMatch match = { int32_t(i), entries[i].isFavorite };
+		matches.push_back(match);
+	}
+
+	// Favorites first if asked for, then by name as the collator sees it,
+	// then by path
+	std::sort(matches.begin(), matches.end(),
+		[&entries, favoritesFirst](const SearchMatch& a, const SearchMatch& b) {
+			if (favoritesFirst && a.isFavorite != b.isFavorite)
+				return a.isFavorite;
+
+			const OracleEntry& entryA = entries[a.index];
+			const OracleEntry& entryB = entries[b.index];
+			if (entryA.sortKey != entryB.sortKey)
+				return entryA.sortKey < entryB.sortKey;
+			return ascii_lower(entryA.path) < ascii_lower(entryB.path);
+		});
+}
+
+
+/*static*/ bool
+SearchOracle::Equals(const std::vector<SearchMatch>& a, const std::vector<SearchMatch>& b)
+{
+	if (a.size() != b.size())
+		return false;
+
+	for (size_t i = 0; i < a.size(); i++) {
+		if (a[i].index != b[i].index || a[i].isFavorite != b[i].isFavorite)
+			return false;
+	}
+	return true;
+}
+
+
+/*static*/ int32_t
+SearchOracle::CheckRandomized(int32_t rounds, uint32_t seed, FILE* report)
+{
+	Random random(seed);
+	int32_t mismatches = 0;
+	for (int32_t round = 0; round < rounds; round++) {
+		TestCase test = random_case(random);
+		if (!fails(test))
+			continue;
+
+		mismatches++;
+		shrink(test);
+		fprintf(report, "Search mismatch in round %" PRId32 " (seed %" PRIu32 "):\n", round,
+			seed);
+		print_case(report, test);
+	}
+
+	fprintf(report, "%" PRId32 " of %" PRId32 " rounds mismatched (seed %" PRIu32 ")\n",
+		mismatches, rounds, seed);
+	return mismatches;
+}
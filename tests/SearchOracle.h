@@ -0,0 +1,57 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+#ifndef SEARCHORACLE_H
+#define SEARCHORACLE_H
+
+
+#include "SearchEngine.h"
+
+#include <stdio.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+
+// What a search has to return, written the simplest way possible: every
+// name is copied and lowercased, every entry looked at, and the matches
+// are sorted afterwards. It's slow, but easy to see right, and the app's
+// way (a list kept in display order, searched by the SearchEngine) has to
+// return exactly the same.
+
+// An entry of a catalog in no particular order
+struct OracleEntry {
+	std::string				name;
+	std::string				path;
+	// What the collator made of the name
+	std::string				sortKey;
+	bool					isFavorite;
+};
+
+
+class SearchOracle {
+public:
+	typedef std::function<bool(const std::string& path)> IgnoreFunction;
+
+	// The matches' indices are those of the entries
+	static	void			Search(const std::vector<OracleEntry>& entries,
+								const char* text, bool searchFromStart, bool applyIgnore,
+								bool favoritesFirst, const IgnoreFunction& isIgnored,
+								std::vector<SearchMatch>& matches);
+
+	static	bool			Equals(const std::vector<SearchMatch>& a,
+								const std::vector<SearchMatch>& b);
+
+	// Runs the app's way and the oracle on random cases. Mismatches are
+	// shrunk to a minimal case and written to the report. Returns the
+	// number of mismatching rounds.
+	static	int32_t			CheckRandomized(int32_t rounds, uint32_t seed, FILE* report);
+};
+
+
+#endif // SEARCHORACLE_H
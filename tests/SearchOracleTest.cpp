@@ -0,0 +1,35 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "SearchOracle.h"
+
+#include <stdlib.h>
+
+
+// Compares the app's search with the oracle on random catalogs, queries and
+// ignore lists. Usage: SearchOracleTest [rounds [seed]], a mismatch reports
+// its seed to repeat the run with.
+
+static const int32_t kDefaultRounds = 20000;
+static const uint32_t kDefaultSeed = 2463534242u;
+
+
+int
+main(int argc, char** argv)
+{
+	int32_t rounds = argc > 1 ? atoi(argv[1]) : kDefaultRounds;
+	uint32_t seed = argc > 2 ? strtoul(argv[2], NULL, 10) : kDefaultSeed;
+
+	if (SearchOracle::CheckRandomized(rounds, seed, stdout) != 0) {
+		fprintf(stderr, "SearchOracleTest: failed\n");
+		return 1;
+	}
+
+	printf("SearchOracleTest: passed\n");
+	return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+
+#include "SyntheticCatalog.h"
+
+#include <stdio.h>
+
+
+// Mostly ASCII syllables, with some accented, Cyrillic, Greek and CJK ones
+// in about the share localized app names have
+static const char* kSyllables[] = {
+	"a", "ap", "ar", "be", "bo", "ca", "clip", "co", "da", "de", "dit", "e",
+	"ed", "er", "fa", "fi", "ga", "go", "har", "i", "in", "ju", "ka", "ker",
+	"la", "le", "lo", "ma", "me", "mo", "na", "net", "o", "on", "pa", "pe",
+	"pix", "po", "ra", "re", "ri", "sa", "se", "so", "sta", "ta", "te", "ter",
+	"to", "tra", "u", "un", "va", "ve", "vi", "wa", "xi", "yo", "za", "zo",
+	"é", "è", "ü", "ö", "ñ", "ß", "ça", "ø",
+	"ка", "ро", "ль", "ημ", "ερ", "日", "本", "文", "字", "編", "集"
+};
+static const int32_t kSyllableCount = sizeof(kSyllables) / sizeof(kSyllables[0]);
+static const int32_t kAsciiSyllableCount = 60;
+
+static const char* kSuffixes[] = {
+	" Pro", " Lite", " 2", " Viewer", " Editor", " Player", "Tracker", "Edit"
+};
+static const int32_t kSuffixCount = sizeof(kSuffixes) / sizeof(kSuffixes[0]);
+
+// Some of these fall under the default ignore list
+static const char* kFolders[] = {
+	"/boot/system/apps",
+	"/boot/system/apps",
+	"/boot/system/apps",
+	"/boot/system/preferences",
+	"/boot/system/demos",
+	"/boot/system/servers",
+	"/boot/system/bin",
+	"/boot/system/add-ons/Tracker",
+	"/boot/home/config/non-packaged/apps",
+	"/boot/home/config/non-packaged/bin",
+	"/boot/home/Desktop/projects/build"
+};
+static const int32_t kFolderCount = sizeof(kFolders) / sizeof(kFolders[0]);
+
+
+SyntheticCatalog::SyntheticCatalog(int32_t count)
+	:
+	fCount(count),
+	fIndex(0),
+	fState(2463534242u)
+{
+}
+
+
+bool
+SyntheticCatalog::GetNext(std::string& name, std::string& path)
+{
+	if (fIndex >= fCount)
+		return false;
+
+	name.clear();
+	_AppendWord(name);
+
+	// Most app names are one or two words, few are longer
+	uint32_t words = Random(10);
+	if (words >= 5) {
+		name += " ";
+		_AppendWord(name);
+	}
+	if (words >= 9) {
+		name += " ";
+		_AppendWord(name);
+	}
+	if (Random(6) == 0)
+		name += kSuffixes[Random(kSuffixCount)];
+
+	// Keep names unique, as different apps with the same name would be
+	// told apart by their path alone
+	char index[16];
+	snprintf(index, sizeof(index), "%d", int(fIndex));
+	if (Random(4) == 0)
+		name.append(" ").append(index);
+
+	path.assign(kFolders[Random(kFolderCount)]).append("/").append(index)
+		.append("/").append(name);
+
+	fIndex++;
+	return true;
+}
+
+
+uint32_t
+SyntheticCatalog::Random()
+{
+	// xorshift32, the same sequence on every platform
+	fState ^= fState << 13;
+	fState ^= fState >> 17;
+	fState ^= fState << 5;
+	return fState;
+}
+
+
+#pragma mark-- Private Methods --
+
+
+void
+SyntheticCatalog::_AppendWord(std::string& name)
+{
+	size_t start = name.size();
+	uint32_t syllables = 1 + Random(4);
+	for (uint32_t i = 0; i < syllables; i++) {
+		// One in eight syllables is non-ASCII
+		if (Random(8) == 0)
+			name += kSyllables[kAsciiSyllableCount + Random(kSyllableCount - kAsciiSyllableCount)];
+		else
+			name += kSyllables[Random(kAsciiSyllableCount)];
+	}
+
+	// Capitalize ASCII words like most app names
+	char& first = name[start];
+	if (first >= 'a' && first <= 'z')
+		first -= 'a' - 'A';
+}
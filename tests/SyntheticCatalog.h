@@ -0,0 +1,41 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+#ifndef SYNTHETICCATALOG_H
+#define SYNTHETICCATALOG_H
+
+
+#include <stdint.h>
+#include <string>
+
+
+// A made-up catalog of apps for the benchmarks. The same size always
+// produces the same names and paths, so runs can be compared with each
+// other and with the baseline. Names vary in length and about one syllable
+// in eight is non-ASCII, some paths fall under the default ignore list.
+
+class SyntheticCatalog {
+public:
+							SyntheticCatalog(int32_t count);
+
+	bool					GetNext(std::string& name, std::string& path);
+	int32_t					Index() const { return fIndex; };
+
+	uint32_t				Random();
+	uint32_t				Random(uint32_t range) { return Random() % range; };
+
+private:
+	void					_AppendWord(std::string& name);
+
+private:
+	int32_t					fCount;
+	int32_t					fIndex;
+	uint32_t				fState;
+};
+
+
+#endif // SYNTHETICCATALOG_H
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+#ifndef TEST_H
+#define TEST_H
+
+
+#include <stdio.h>
+
+
+// Just enough for the host tests: a failed CHECK() is reported and the
+// test carries on, main() returns test_result() as its exit status.
+
+static int sFailedChecks = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, \
+				#condition); \
+			sFailedChecks++; \
+		} \
+	} while (false)
+
+
+static inline int
+test_result(const char* name)
+{
+	if (sFailedChecks > 0) {
+		fprintf(stderr, "%s: %d checks failed\n", name, sFailedChecks);
+		return 1;
+	}
+
+	printf("%s: passed\n", name);
+	return 0;
+}
+
+
+#endif // TEST_H
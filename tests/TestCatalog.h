@@ -0,0 +1,47 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Distributed under the terms of the MIT license.
+ *
+ * Author:
+ *	Humdinger, humdinger@mailbox.org
+ */
+#ifndef TESTCATALOG_H
+#define TESTCATALOG_H
+
+
+#include "SearchEngine.h"
+
+#include <string>
+#include <vector>
+
+
+// An app list in memory, what the AppList hands to the engine in the app
+
+class TestCatalog : public EntryProvider {
+public:
+	void Add(const std::string& name, const std::string& path, bool isFavorite = false)
+	{
+		names.push_back(name);
+		paths.push_back(path);
+		favorites.push_back(isFavorite);
+	}
+
+	void MakeEmpty()
+	{
+		names.clear();
+		paths.clear();
+		favorites.clear();
+	}
+
+	int32_t CountEntries() const { return names.size(); }
+	const char* NameAt(int32_t index) const { return names[index].c_str(); }
+	const char* PathAt(int32_t index) const { return paths[index].c_str(); }
+	bool IsFavorite(int32_t index) const { return favorites[index]; }
+
+	std::vector<std::string> names;
+	std::vector<std::string> paths;
+	std::vector<bool>		favorites;
+};
+
+
+#endif // TESTCATALOG_H